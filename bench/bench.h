@@ -0,0 +1,90 @@
+#ifndef _BENCH_H_
+#define _BENCH_H_
+
+#include <cstdio>
+#include <cmath>
+#include <chrono>
+#include <vector>
+
+/*
+	Timing and JSON output shared by the kernel benchmarks. Each kernel
+	runs once to warm the caches and then a fixed number of times over the
+	same inputs, so that runs on the same machine can be compared.
+*/
+
+/// Timings of one kernel
+struct BenchResult
+{
+	const char *name;
+	long ops;		// operations per run
+	int runs;
+	double mean;		// ns per operation
+	double stddev;
+	double min;
+};
+
+/// Runs kernels and collects their timings
+class Bench
+{
+public:
+	static const int RUNS = 15;
+
+	/// Time a kernel
+	/**
+		@param name	the name reported in the JSON output
+		@param ops	number of operations done by one call of f
+		@param f	callable doing ops operations. It returns a value
+				that is accumulated so the work can't be optimized away.
+	*/
+	template <class F> void run(const char *name, long ops, F f)
+	{
+		double times[RUNS];
+
+		sink += f();
+		for(int i = 0; i < RUNS; i++)
+		{
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			sink += f();
+			times[i] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() * 1e9 / ops;
+		}
+
+		BenchResult r = {name, ops, RUNS, 0.0, 0.0, times[0]};
+		for(int i = 0; i < RUNS; i++)
+		{
+			r.mean += times[i] / RUNS;
+			if(times[i] < r.min) r.min = times[i];
+		}
+		for(int i = 0; i < RUNS; i++) r.stddev += (times[i] - r.mean) * (times[i] - r.mean) / (RUNS - 1);
+		r.stddev = sqrt(r.stddev);
+
+		fprintf(stderr, "%-28s %12.1f ns/op  +- %.1f\n", name, r.mean, r.stddev);
+		results.push_back(r);
+	}
+
+	/// The timings so far, in the order the kernels ran
+	const std::vector<BenchResult> &getResults() const
+	{
+		return results;
+	}
+	
+	/// Print the results as a JSON array
+	void writeJson(FILE *out) const
+	{
+		fprintf(out, "[\n");
+		for(unsigned int i = 0; i < results.size(); i++)
+		{
+			const BenchResult &r = results[i];
+			fprintf(out, "  {\"name\": \"%s\", \"ops\": %ld, \"runs\": %d, \"ns_per_op\": %.3f, "
+				"\"stddev_ns\": %.3f, \"min_ns\": %.3f, \"ops_per_sec\": %.1f}%s\n",
+				r.name, r.ops, r.runs, r.mean, r.stddev, r.min, 1e9 / r.mean,
+				i + 1 < results.size() ? "," : "");
+		}
+		fprintf(out, "]\n");
+	}
+
+private:
+	std::vector<BenchResult> results;
+	volatile double sink = 0.0;
+};
+
+#endif
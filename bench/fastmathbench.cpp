@@ -0,0 +1,240 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <map>
+
+#include "fastmath.h"
+
+/*
+	Checks the approximations in fastmath.h against libm, on the ranges
+	the physics and the culling feed them, and times both.
+
+	Given two outputs of antigrav-batch it instead checks that the race
+	outcomes of a build configured with --enable-fast-math match those of
+	a libm build. The bots are chaotic, so single races diverge with any
+	change to the arithmetic; the check compares the finish rate and the
+	distance covered per player count, and fails when they differ by more
+	than three standard errors:
+
+		antigrav-batch -s 1-100 -p 1,8 -t 60 -o libm.csv
+		(reconfigure with --enable-fast-math and rebuild)
+		antigrav-batch -s 1-100 -p 1,8 -t 60 -o fast.csv
+		fastmathbench libm.csv fast.csv
+*/
+
+static const int NUM_SAMPLES = 1000000;
+static const int TIMING_ROUNDS = 20;
+
+static float libmTan(float x) { return tan(x); }
+static float libmExp(float x) { return exp(x); }
+static float libmAcos(float x) { return acosf(x); }
+static double exactTan(double x) { return tan(x); }
+static double exactExp(double x) { return exp(x); }
+static double exactAcos(double x) { return acos(x); }
+
+// Time per call, with the function inlined into the loop as at the call sites
+template <float (*F)(float)>
+static double measureTime(const float *x)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	volatile float sink;
+	float sum = 0.0;
+	for(int r = 0; r < TIMING_ROUNDS; r++)
+	{
+		for(int i = 0; i < NUM_SAMPLES; i++) sum += F(x[i]);
+	}
+	sink = sum;
+	(void)sink;
+
+	double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return t * 1e9 / ((double)TIMING_ROUNDS * NUM_SAMPLES);
+}
+
+struct Kernel
+{
+	const char *name;
+	float min, max;
+	bool relative;
+	float (*fast)(float);
+	float (*libm)(float);
+	double (*exact)(double);
+	double (*timeFast)(const float *);
+	double (*timeLibm)(const float *);
+};
+
+// tan is measured where it is below 1000, as it is in the physics
+static const Kernel KERNELS[] = {
+	{"tan", -M_PI, M_PI, true, fastTan, libmTan, exactTan,
+		measureTime<fastTan>, measureTime<libmTan>},
+	{"exp", -87.0, 10.0, true, fastExp, libmExp, exactExp,
+		measureTime<fastExp>, measureTime<libmExp>},
+	{"acos", -1.0, 1.0, false, fastAcos, libmAcos, exactAcos,
+		measureTime<fastAcos>, measureTime<libmAcos>},
+};
+static const int NUM_KERNELS = sizeof(KERNELS) / sizeof(KERNELS[0]);
+
+static double measureError(const Kernel &k, float (*f)(float))
+{
+	double worst = 0.0;
+	for(int i = 0; i <= NUM_SAMPLES; i++)
+	{
+		float x = k.min + (k.max - k.min) * i / NUM_SAMPLES;
+		double exact = k.exact(x);
+		if(k.relative && (exact == 0.0 || fabs(exact) > 1000.0)) continue;
+
+		double error = fabs(f(x) - exact);
+		if(k.relative) error /= fabs(exact);
+		if(error > worst) worst = error;
+	}
+	return worst;
+}
+
+static int accuracy()
+{
+	float *x = new float[NUM_SAMPLES];
+
+	printf("%-6s %14s %14s %10s %10s\n", "kernel", "libm error", "fast error", "libm ns", "fast ns");
+
+	for(int n = 0; n < NUM_KERNELS; n++)
+	{
+		const Kernel &k = KERNELS[n];
+
+		// the physics calls them with slowly changing arguments, so
+		// time a random walk over the range rather than random values
+		srand(n + 1);
+		float walk = 0.5 * (k.min + k.max);
+		for(int i = 0; i < NUM_SAMPLES; i++)
+		{
+			walk += (k.max - k.min) * 0.01 * (rand() / (float)RAND_MAX - 0.5);
+			if(walk < k.min) walk = k.min;
+			if(walk > k.max) walk = k.max;
+			x[i] = walk;
+		}
+
+		printf("%-6s %14.3g %14.3g %10.2f %10.2f\n", k.name, measureError(k, k.libm),
+			measureError(k, k.fast), k.timeLibm(x), k.timeFast(x));
+	}
+
+	delete [] x;
+	return 0;
+}
+
+/// Running mean and standard error of a race outcome
+struct Stat
+{
+	double sum, sumSq;
+	int n;
+
+	Stat() : sum(0.0), sumSq(0.0), n(0) {}
+	void add(double v) { sum += v; sumSq += v * v; n++; }
+	double mean() const { return sum / n; }
+	double error() const { return sqrt(fmax(sumSq / n - mean() * mean(), 0.0) / n); }
+};
+
+struct Outcome
+{
+	Stat finished, distance;
+};
+
+static bool readRaces(const char *file, std::map<int, Outcome> &outcomes)
+{
+	FILE *in = fopen(file, "r");
+	if(in == NULL)
+	{
+		fprintf(stderr, "Can't open %s\n", file);
+		return false;
+	}
+
+	char line[1024];
+	int players = -1, finished = -1, distance = -1;
+
+	if(fgets(line, sizeof(line), in) != NULL)
+	{
+		int column = 0;
+		for(char *field = strtok(line, ",\n"); field; field = strtok(NULL, ",\n"), column++)
+		{
+			if(strcmp(field, "players") == 0) players = column;
+			else if(strcmp(field, "finished") == 0) finished = column;
+			else if(strcmp(field, "distance") == 0) distance = column;
+		}
+	}
+
+	if(players < 0 || finished < 0 || distance < 0)
+	{
+		fprintf(stderr, "%s is not a CSV file from antigrav-batch\n", file);
+		fclose(in);
+		return false;
+	}
+
+	while(fgets(line, sizeof(line), in) != NULL)
+	{
+		double value[3] = {0.0, 0.0, 0.0};
+		int column = 0;
+		for(char *field = strtok(line, ",\n"); field; field = strtok(NULL, ",\n"), column++)
+		{
+			if(column == players) value[0] = atof(field);
+			else if(column == finished) value[1] = atof(field);
+			else if(column == distance) value[2] = atof(field);
+		}
+
+		Outcome &outcome = outcomes[(int)value[0]];
+		outcome.finished.add(value[1]);
+		outcome.distance.add(value[2]);
+	}
+
+	fclose(in);
+	return true;
+}
+
+static bool compareStat(const char *name, int players, const Stat &a, const Stat &b)
+{
+	double diff = b.mean() - a.mean();
+	double limit = 3.0 * sqrt(a.error() * a.error() + b.error() * b.error());
+	bool ok = fabs(diff) <= limit;
+
+	printf("%7d %-9s %10.4f %10.4f %10.4f %10.4f  %s\n", players, name, a.mean(), b.mean(),
+		diff, limit, ok ? "ok" : "DIFFERS");
+	return ok;
+}
+
+static int compare(const char *reference, const char *candidate)
+{
+	std::map<int, Outcome> a, b;
+	if(!readRaces(reference, a) || !readRaces(candidate, b)) return 2;
+
+	printf("%7s %-9s %10s %10s %10s %10s\n", "players", "outcome", "reference", "candidate",
+		"diff", "limit");
+
+	bool ok = true;
+	for(std::map<int, Outcome>::iterator i = a.begin(); i != a.end(); ++i)
+	{
+		std::map<int, Outcome>::iterator j = b.find(i->first);
+		if(j == b.end())
+		{
+			printf("%7d missing from %s\n", i->first, candidate);
+			ok = false;
+			continue;
+		}
+
+		ok &= compareStat("finished", i->first, i->second.finished, j->second.finished);
+		ok &= compareStat("distance", i->first, i->second.distance, j->second.distance);
+	}
+
+	return ok ? 0 : 1;
+}
+
+int main(int argc, char *argv[])
+{
+	if(argc == 3) return compare(argv[1], argv[2]);
+
+	if(argc != 1)
+	{
+		fprintf(stderr, "Usage: %s [reference.csv candidate.csv]\n", argv[0]);
+		return 2;
+	}
+
+	return accuracy();
+}
@@ -0,0 +1,115 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <chrono>
+#include <algorithm>
+
+#include "sim.h"
+
+/*
+	Compares the fixed step and the adaptive integrators against a
+	reference run with tiny fixed steps. Each run launches one craft from
+	the starting grid and lets it ride its hover beam over the track with
+	no controls pressed, as controls and contacts are applied once per
+	tick and would make every integrator look first order.
+*/
+
+static const int NUM_SEEDS = 20;
+static const float HORIZON = 1.0;
+static const float LAUNCH_SPEED = 2.0;
+static const float REFERENCE_RATE = 240.0 * 16.0;
+
+struct Config
+{
+	const char *name;
+	int integrator;
+	float rate;
+	float tolerance;
+};
+
+static const Config CONFIGS[] = {
+	{"rkn 15 Hz", World::INTEGRATE_SCALAR, 15.0, 0.0},
+	{"rkn 30 Hz", World::INTEGRATE_SCALAR, 30.0, 0.0},
+	{"rkn 60 Hz", World::INTEGRATE_SCALAR, 60.0, 0.0},
+	{"rkn 240 Hz", World::INTEGRATE_SCALAR, 240.0, 0.0},
+	{"15 Hz 1e-3", World::INTEGRATE_ADAPTIVE, 15.0, 1e-3},
+	{"15 Hz 1e-4", World::INTEGRATE_ADAPTIVE, 15.0, 1e-4},
+	{"15 Hz 1e-5", World::INTEGRATE_ADAPTIVE, 15.0, 1e-5},
+	{"60 Hz 1e-3", World::INTEGRATE_ADAPTIVE, 60.0, 1e-3},
+	{"60 Hz 1e-5", World::INTEGRATE_ADAPTIVE, 60.0, 1e-5},
+};
+static const int NUM_CONFIGS = sizeof(CONFIGS) / sizeof(CONFIGS[0]);
+
+struct Result
+{
+	Vector2 pos;
+	int derives;
+	double wallTime;
+};
+
+static Result fly(int seed, int integrator, float rate, float tolerance)
+{
+	World *world = new World();
+	world->init();
+	world->generate(seed);
+	world->setNumPlayers(1);
+	world->setIntegrator(integrator);
+	world->setTolerance(tolerance);
+	world->setMaxSubSteps(1);
+	world->getPlayer(0).setActive(true);
+	world->reset();
+	
+	Craft &craft = world->getActiveCraft(0);
+	craft.setVel(Vector2(LAUNCH_SPEED, 0.0));
+	
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	
+	const int ticks = (int)(HORIZON * rate + 0.5);
+	for(int i = 0; i < ticks; i++) world->update(1.0 / rate);
+	
+	Result r;
+	r.wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	r.pos = craft.getPos();
+	r.derives = world->getDerives();
+	
+	delete world;
+	return r;
+}
+
+int main()
+{
+	Result reference[NUM_SEEDS];
+	for(int s = 0; s < NUM_SEEDS; s++)
+	{
+		reference[s] = fly(s + 1, World::INTEGRATE_SCALAR, REFERENCE_RATE, 0.0);
+	}
+	
+	printf("%-14s %12s %12s %14s %10s\n", "integrator", "median error", "max error",
+		"derives/sec", "us/sec");
+	
+	for(int c = 0; c < NUM_CONFIGS; c++)
+	{
+		const Config &config = CONFIGS[c];
+		double errors[NUM_SEEDS], wall = 0.0;
+		long derives = 0;
+		
+		for(int s = 0; s < NUM_SEEDS; s++)
+		{
+			Result r = fly(s + 1, config.integrator, config.rate, config.tolerance);
+			errors[s] = (r.pos - reference[s].pos).length();
+			derives += r.derives;
+			wall += r.wallTime;
+		}
+		
+		// a few runs touch the track, which is handled once per tick
+		// whatever the integrator, so the median is more telling
+		std::sort(errors, errors + NUM_SEEDS);
+		
+		const double simTime = NUM_SEEDS * HORIZON;
+		printf("%-14s %12.7f %12.7f %14.1f %10.1f\n", config.name, errors[NUM_SEEDS / 2],
+			errors[NUM_SEEDS - 1], derives / simTime, wall * 1e6 / simTime);
+	}
+	
+	return 0;
+}
+
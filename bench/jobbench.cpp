@@ -0,0 +1,174 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <thread>
+#include <getopt.h>
+
+#include "sim.h"
+#include "bench.h"
+
+/*
+	Scaling of the WorkerPool job system. Every kernel runs on pools of
+	1, 2, 4, ... threads: the cost of empty jobs, jobs of fixed work,
+	jobs that wait for nested jobs, level generation and a world step of
+	a large field of crafts. The timings go to stdout as JSON, and the
+	speedups over one thread to stderr.
+*/
+
+static const int EMPTY_JOBS = 4096;
+static const int BUSY_JOBS = 256;
+static const int BUSY_WORK = 4000;
+static const int NESTED_JOBS = 16;
+static const int NUM_CRAFTS = 256;
+static const int NUM_TICKS = 10;
+static const float DT = 1.0 / 240.0;
+
+static const int NUM_KERNELS = 5;
+static const char *KERNELS[NUM_KERNELS] = {"empty job", "busy job", "nested job", "Level::generate", "World::update"};
+
+static const int MAX_POOLS = 16;
+
+static float results[BUSY_JOBS];
+static float nested[NESTED_JOBS][NESTED_JOBS];
+
+static void emptyJob(int, void *)
+{
+}
+
+// writes its result to arg[n], or to results[n] if arg is NULL
+static void busyJob(int n, void *arg)
+{
+	float x = n;
+	for(int i = 0; i < BUSY_WORK; i++) x = x * 0.999f + 1.0f;
+	(arg != NULL ? (float *)arg : results)[n] = x;
+}
+
+// a job that waits for jobs of its own
+static void nestedJob(int n, void *arg)
+{
+	WorkerPool *pool = (WorkerPool *)arg;
+	WorkerPool::TaskGroup group(pool);
+	group.spawn(NESTED_JOBS, busyJob, nested[n]);
+	group.wait();
+}
+
+static void benchPool(Bench &bench, int threads, char names[NUM_KERNELS][64])
+{
+	WorkerPool *pool = new WorkerPool(threads);
+	for(int k = 0; k < NUM_KERNELS; k++) snprintf(names[k], 64, "%s, %d thread%s", KERNELS[k], threads, threads == 1 ? "" : "s");
+
+	bench.run(names[0], EMPTY_JOBS, [pool]() {
+		pool->run(EMPTY_JOBS, emptyJob, NULL);
+		return 0;
+	});
+
+	bench.run(names[1], BUSY_JOBS, [pool]() {
+		pool->run(BUSY_JOBS, busyJob, NULL);
+		return results[BUSY_JOBS - 1];
+	});
+
+	bench.run(names[2], NESTED_JOBS * NESTED_JOBS, [pool]() {
+		pool->run(NESTED_JOBS, nestedJob, pool);
+		return nested[NESTED_JOBS - 1][NESTED_JOBS - 1];
+	});
+
+	Level *level = new Level();
+	level->init();
+	level->setWorkerPool(pool);
+	bench.run(names[3], 1, [level]() {
+		level->generate(1);
+		return level->getHeight(10.0);
+	});
+	delete level;
+
+	World *world = new World();
+	world->setNumPlayers(NUM_CRAFTS);
+	world->init();
+	world->setWorkerPool(pool);
+	world->generate(1);
+	for(int i = 0; i < NUM_CRAFTS; i++) world->getPlayer(i).setActive(true);
+	world->reset();
+	for(int i = 0; i < 60; i++) world->update(DT);
+
+	bench.run(names[4], NUM_TICKS, [world]() {
+		for(int i = 0; i < NUM_TICKS; i++) world->update(DT);
+		return world->getActiveCraft(0).getY();
+	});
+	delete world;
+
+	delete pool;
+}
+
+const char *help_msg =
+"Usage: jobbench [options]\n\
+Options:\n\
+  -h, --help\t\tprint this help, then exit\n\
+  -o, --output=FILE\twrite the JSON results to FILE instead of stdout\n\
+  -t, --threads=N\tlargest pool to time, default one thread per core\n";
+
+int main(int argc, char *argv[])
+{
+	const char *output = NULL;
+	int maxThreads = std::thread::hardware_concurrency();
+
+	while(1)
+	{
+		static struct option long_options[] = {
+			{"help", 0, 0, 'h'},
+			{"output", 1, 0, 'o'},
+			{"threads", 1, 0, 't'},
+			{0, 0, 0, 0}
+		};
+
+		int c = getopt_long(argc, argv, "ho:t:", long_options, NULL);
+		if(c == -1) break;
+
+		switch(c)
+		{
+			case 'o':
+				output = optarg;
+				break;
+			case 't':
+				maxThreads = atoi(optarg);
+				break;
+			case 'h':
+			default:
+				printf("%s", help_msg);
+				return c == 'h' ? 0 : 1;
+		}
+	}
+
+	if(maxThreads < 1) maxThreads = 1;
+
+	// 1, 2, 4, ... threads, and the largest pool even if it isn't a power of two
+	int threads[MAX_POOLS], numPools = 0;
+	for(int t = 1; t < maxThreads && numPools < MAX_POOLS - 1; t *= 2) threads[numPools++] = t;
+	threads[numPools++] = maxThreads;
+
+	static char names[MAX_POOLS][NUM_KERNELS][64];
+	Bench bench;
+	for(int p = 0; p < numPools; p++) benchPool(bench, threads[p], names[p]);
+
+	const std::vector<BenchResult> &r = bench.getResults();
+	fprintf(stderr, "\n%-16s", "speedup");
+	for(int p = 0; p < numPools; p++) fprintf(stderr, " %7d", threads[p]);
+	fprintf(stderr, "\n");
+	for(int k = 0; k < NUM_KERNELS; k++)
+	{
+		fprintf(stderr, "%-16s", KERNELS[k]);
+		for(int p = 0; p < numPools; p++) fprintf(stderr, " %7.2f", r[k].mean / r[p * NUM_KERNELS + k].mean);
+		fprintf(stderr, "\n");
+	}
+
+	FILE *out = stdout;
+	if(output != NULL && (out = fopen(output, "w")) == NULL)
+	{
+		fprintf(stderr, "Can't open %s\n", output);
+		return 1;
+	}
+
+	bench.writeJson(out);
+	if(out != stdout) fclose(out);
+
+	return 0;
+}
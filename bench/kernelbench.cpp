@@ -0,0 +1,260 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <getopt.h>
+
+#include "sim.h"
+#include "bench.h"
+
+/*
+	Microbenchmarks of the physics and geometry kernels. Every kernel
+	works on inputs generated from fixed seeds, and the results go to
+	stdout as JSON, with a readable summary on stderr.
+*/
+
+static const int NUM_CRAFTS = 8;
+static const int NUM_CASES = 256;
+static const float DT = 1.0 / 240.0;
+
+// the size of the height field behind a Level
+static const int TERRAIN_WIDTH = 512;
+static const int TERRAIN_HEIGHT = 32;
+
+// uniform random number in [a, b), from a fixed seed
+static float uniform(float a, float b)
+{
+	return a + (b - a) * (rand() / ((float)RAND_MAX + 1.0f));
+}
+
+static void benchUpdate(Bench &bench)
+{
+	World *world = new World();
+	world->init();
+	world->generate(1);
+	for(int i = 0; i < NUM_CRAFTS; i++) world->getPlayer(i).setActive(true);
+	world->reset();
+
+	// let the crafts settle on their beams, then integrate the same
+	// states over and over
+	for(int i = 0; i < 240; i++) world->update(DT);
+
+	bench.run("Craft::update", NUM_CRAFTS * 2000, [world]() {
+		float sum = 0.0;
+		for(int k = 0; k < 2000; k++)
+		{
+			for(int i = 0; i < NUM_CRAFTS; i++)
+			{
+				Craft &craft = world->getActiveCraft(i);
+				craft.update(DT);
+				sum += craft.getDY();
+			}
+		}
+		return sum;
+	});
+
+	delete world;
+}
+
+static void benchCheckCollision(Bench &bench)
+{
+	// about a quarter of the pairs touch
+	std::vector<Craft> crafts(2 * NUM_CASES);
+	srand(1);
+	for(int i = 0; i < NUM_CASES; i++)
+	{
+		Craft &a = crafts[2 * i], &b = crafts[2 * i + 1];
+		a.setPos(Vector2(10.0, 5.0));
+		a.setAngle(uniform(-0.5, 0.5));
+
+		float r = uniform(0.0, 4.0 * Craft::RADIUS), theta = uniform(0.0, 2.0 * M_PI);
+		b.setPos(a.getPos() + Vector2(r * cos(theta), r * sin(theta)));
+		b.setAngle(uniform(-0.5, 0.5));
+		
+		a.updateBox();
+		b.updateBox();
+	}
+
+	bench.run("Craft::checkCollision", NUM_CASES * 100, [&crafts]() {
+		int hits = 0;
+		for(int k = 0; k < 100; k++)
+		{
+			for(int i = 0; i < NUM_CASES; i++)
+			{
+				Vector2 point, normal;
+				if(crafts[2 * i].checkCollision(crafts[2 * i + 1], point, normal)) hits++;
+			}
+		}
+		return hits;
+	});
+}
+
+static void benchLevel(Bench &bench)
+{
+	Level *level = new Level();
+	level->init();
+	level->generate(1);
+
+	// hover beams from above the track, pointing down within 60 degrees
+	Vector2 from[NUM_CASES], to[NUM_CASES];
+	srand(2);
+	for(int i = 0; i < NUM_CASES; i++)
+	{
+		float x = uniform(5.0, level->getWidth() - 5.0);
+		float angle = uniform(-M_PI / 3.0, M_PI / 3.0);
+		from[i] = Vector2(x, level->getHeight(x) + uniform(0.2, 3.0));
+		to[i] = from[i] + 5.0 * Vector2(sin(angle), -cos(angle));
+	}
+
+	bench.run("Level::intersect", NUM_CASES * 20, [&]() {
+		int hits = 0;
+		for(int k = 0; k < 20; k++)
+		{
+			for(int i = 0; i < NUM_CASES; i++)
+			{
+				Vector2 point;
+				if(level->intersect(from[i], to[i], point)) hits++;
+			}
+		}
+		return hits;
+	});
+
+	// crafts near a track segment, half of them touching it
+	Vector2 center[NUM_CASES], start[NUM_CASES], end[NUM_CASES];
+	float angle[NUM_CASES];
+	srand(3);
+	for(int i = 0; i < NUM_CASES; i++)
+	{
+		float x = uniform(5.0, level->getWidth() - 5.0);
+		start[i] = Vector2(x - 0.25, level->getHeight(x - 0.25));
+		end[i] = Vector2(x + 0.25, level->getHeight(x + 0.25));
+		center[i] = Vector2(x, level->getHeight(x) + uniform(-0.1, 0.3));
+		angle[i] = uniform(-0.5, 0.5);
+	}
+
+	bench.run("Level::ellipseIntersect", NUM_CASES * 100, [&]() {
+		int hits = 0;
+		for(int k = 0; k < 100; k++)
+		{
+			for(int i = 0; i < NUM_CASES; i++)
+			{
+				Vector2 point, normal, delta;
+				if(level->ellipseIntersect(center[i], angle[i], Craft::MAJOR_AXIS, Craft::MINOR_AXIS,
+					point, normal, delta)) hits++;
+			}
+		}
+		return hits;
+	});
+	
+	bench.run("Level::ellipseSegmentIsect", NUM_CASES * 100, [&]() {
+		int hits = 0;
+		for(int k = 0; k < 100; k++)
+		{
+			for(int i = 0; i < NUM_CASES; i++)
+			{
+				Vector2 point, normal, delta;
+				if(Level::ellipseSegmentIsect(center[i], angle[i], Craft::MAJOR_AXIS, Craft::MINOR_AXIS,
+					start[i], end[i], point, normal, delta)) hits++;
+			}
+		}
+		return hits;
+	});
+
+	delete level;
+}
+
+static void benchRings(Bench &bench)
+{
+	// the rings of a large field of boosting crafts
+	const int n = 100 * RingList::RINGS_PER_CRAFT;
+	const float color[3] = {1.0, 0.0, 0.0};
+	RingList *rings = new RingList();
+	srand(4);
+	for(int i = 0; i < n; i++)
+	{
+		rings->add(Ring(uniform(0.0, 250.0), uniform(0.0, 5.0), uniform(-0.5, 0.5),
+			Vector2(uniform(-2.0, 2.0), uniform(-2.0, 2.0)), color));
+	}
+	
+	// steps short enough that none of them die
+	bench.run("RingList::update", n * 100, [rings]() {
+		for(int k = 0; k < 100; k++) rings->update(1e-6);
+		return rings->getNumRings();
+	});
+	
+	delete rings;
+}
+
+static void benchTerrain(Bench &bench)
+{
+	Terrain *terrain = new Terrain();
+	terrain->init(TERRAIN_WIDTH, TERRAIN_HEIGHT);
+
+	bench.run("Terrain::generate", 4, [terrain]() {
+		for(int i = 0; i < 4; i++)
+		{
+			terrain->srandom(i + 1);
+			terrain->generate();
+		}
+		return terrain->getHeight(1, 1);
+	});
+
+	bench.run("Terrain::computeNormals", 4, [terrain]() {
+		for(int i = 0; i < 4; i++) terrain->computeNormals();
+		return terrain->getHeight(1, 1);
+	});
+
+	delete terrain;
+}
+
+const char *help_msg =
+"Usage: kernelbench [options]\n\
+Options:\n\
+  -h, --help\t\tprint this help, then exit\n\
+  -o, --output=FILE\twrite the JSON results to FILE instead of stdout\n";
+
+int main(int argc, char *argv[])
+{
+	const char *output = NULL;
+
+	while(1)
+	{
+		static struct option long_options[] = {
+			{"help", 0, 0, 'h'},
+			{"output", 1, 0, 'o'},
+			{0, 0, 0, 0}
+		};
+
+		int c = getopt_long(argc, argv, "ho:", long_options, NULL);
+		if(c == -1) break;
+
+		switch(c)
+		{
+			case 'o':
+				output = optarg;
+				break;
+			case 'h':
+			default:
+				printf("%s", help_msg);
+				return c == 'h' ? 0 : 1;
+		}
+	}
+
+	Bench bench;
+	benchUpdate(bench);
+	benchCheckCollision(bench);
+	benchLevel(bench);
+	benchRings(bench);
+	benchTerrain(bench);
+
+	FILE *out = stdout;
+	if(output != NULL && (out = fopen(output, "w")) == NULL)
+	{
+		fprintf(stderr, "Can't open %s\n", output);
+		return 1;
+	}
+
+	bench.writeJson(out);
+	if(out != stdout) fclose(out);
+
+	return 0;
+}
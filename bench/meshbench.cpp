@@ -0,0 +1,67 @@
+#include "SDL.h"
+#include "SDL_opengl.h"
+#include <unistd.h>
+#include <cstdio>
+#include <cstdlib>
+
+#include "tinyxml.h"
+#include "m3dmaterial.h"
+#include "m3dtexture.h"
+#include "m3dmesh.h"
+#include "bench.h"
+
+/*
+	Times m3dMesh::loadFromXML on the game's models, with the same JSON
+	output as kernelbench. The textures are uploaded to OpenGL, so this
+	one needs a display and is only built with the game.
+*/
+
+static const char *MESHES[] = {"racer.xml", "ring.xml"};
+static const int NUM_MESHES = sizeof(MESHES) / sizeof(MESHES[0]);
+
+static const int LOADS = 4;
+
+int main(int argc, char *argv[])
+{
+	const char *dataDir = argc > 1 ? argv[1] : DATADIR;
+	if(chdir(dataDir) != 0)
+	{
+		fprintf(stderr, "Can't find data directory %s\n", dataDir);
+		return 1;
+	}
+
+	if(SDL_Init(SDL_INIT_VIDEO) != 0)
+	{
+		fprintf(stderr, "Can't initialize SDL: %s\n", SDL_GetError());
+		return 1;
+	}
+	atexit(SDL_Quit);
+
+	if(SDL_SetVideoMode(64, 48, 0, SDL_OPENGL) == NULL)
+	{
+		fprintf(stderr, "Can't set video mode: %s\n", SDL_GetError());
+		return 1;
+	}
+
+	Bench bench;
+	char names[NUM_MESHES][64];
+	for(int i = 0; i < NUM_MESHES; i++)
+	{
+		const char *file = MESHES[i];
+		snprintf(names[i], sizeof(names[i]), "m3dMesh::loadFromXML %s", file);
+
+		bench.run(names[i], LOADS, [file]() {
+			int failed = 0;
+			for(int k = 0; k < LOADS; k++)
+			{
+				m3dMesh mesh;
+				if(mesh.loadFromXML(file) != 0) failed++;
+			}
+			return failed;
+		});
+	}
+
+	bench.writeJson(stdout);
+
+	return 0;
+}
@@ -1,6 +1,6 @@
 #include <math.h>
 
-#include "vector2.h"
+#include "oldvector2.h"
 
 /* Constructors */
 /// Create a zero vector
@@ -8,7 +8,7 @@
 	This is the default constructor for the Vector class. Equivalent to Vector(0, 0)
 	@see Vector(float,float)
 */
-Vector2::Vector2()
+OldVector2::OldVector2()
 {
 	data[0] = 0;
 	data[1] = 0;
@@ -20,7 +20,7 @@ Vector2::Vector2()
 	@param xx	The x-component of the vector
 	@param yy	The y-component of the vector
 */
-Vector2::Vector2(float xx, float yy)
+OldVector2::OldVector2(float xx, float yy)
 {
 	data[0] = xx;
 	data[1] = yy;
@@ -31,7 +31,7 @@ Vector2::Vector2(float xx, float yy)
 /**
 	@param xx	the new x-component of this vector.
 */
-void Vector2::setX(float xx)
+void OldVector2::setX(float xx)
 {
 	data[0] = xx;
 }
@@ -40,7 +40,7 @@ void Vector2::setX(float xx)
 /**
 	@param yy	the new x-component of this vector.
 */
-void Vector2::setY(float yy)
+void OldVector2::setY(float yy)
 {
 	data[1] = yy;
 }
@@ -49,7 +49,7 @@ void Vector2::setY(float yy)
 /**
 	@return		The x-component of this vector
 */
-float Vector2::getX() const
+float OldVector2::getX() const
 {
 	return data[0];
 }
@@ -58,7 +58,7 @@ float Vector2::getX() const
 /**
 	@return		The y-component of this vector
 */
-float Vector2::getY() const
+float OldVector2::getY() const
 {
 	return data[1];
 }
@@ -69,7 +69,7 @@ float Vector2::getY() const
 	sqrt(x<sup>2</sup>+y<sup>2</sup>).
 	@return		The lenght of this vector
 */
-float Vector2::length() const
+float OldVector2::length() const
 {
 	return sqrt(data[0] * data[0] + data[1] * data[1]);
 }
@@ -79,7 +79,7 @@ float Vector2::length() const
 	Calculate the angle of this vector. The angle is defined as atan2(y, x);
 	@return 	The angle of this vector in radians.
 */
-float Vector2::angle() const
+float OldVector2::angle() const
 {
 	return atan2(data[1], data[0]);
 }
@@ -91,7 +91,7 @@ float Vector2::angle() const
 	@param	theta	The angle to rotate in radians. Positive means counterclockwise.
 	@return a reference to this vector
 */
-Vector2& Vector2::rotate(float theta)
+OldVector2& OldVector2::rotate(float theta)
 {
 	float c = cos(theta);
 	float s = sin(theta);
@@ -107,7 +107,7 @@ Vector2& Vector2::rotate(float theta)
 	This function normalizes this vector, when a vector is normalized, it preserves
 	it direction, but is scaled to have a length of 1.0.
 */
-Vector2& Vector2::normalize()
+OldVector2& OldVector2::normalize()
 {
 	float len = sqrt(data[0] * data[0] + data[1] * data[1]);
 	data[0] /= len;
@@ -116,24 +116,24 @@ Vector2& Vector2::normalize()
 	return *this;
 }
 
-Vector2 Vector2::operator+(const Vector2 &vec) const
+OldVector2 OldVector2::operator+(const OldVector2 &vec) const
 {
-	return Vector2(getX() + vec.getX(), getY() + vec.getY());
+	return OldVector2(getX() + vec.getX(), getY() + vec.getY());
 }
 
-Vector2 Vector2::operator-(const Vector2 &vec) const
+OldVector2 OldVector2::operator-(const OldVector2 &vec) const
 {
-	return Vector2(getX() - vec.getX(), getY() - vec.getY());
+	return OldVector2(getX() - vec.getX(), getY() - vec.getY());
 }
 
 /// Get the unit vector of this vector
 /**
 	The unit vector is a vector with the same direction as this one, but a length of 1.0.
-	@return		A new Vector2 which is the unit vector of this vector.
+	@return		A new OldVector2 which is the unit vector of this vector.
 */
-Vector2 Vector2::unitVector() const
+OldVector2 OldVector2::unitVector() const
 {
-	Vector2 temp(data[0], data[1]);
+	OldVector2 temp(data[0], data[1]);
 	temp.normalize();
 	return temp;
 }
@@ -144,12 +144,12 @@ Vector2 Vector2::unitVector() const
 	this vector (ie. the two vectors form a 90 degree angle).
 	@return		A vector that is normal to this vector and equal in length.
 */
-Vector2 Vector2::normalVector() const
+OldVector2 OldVector2::normalVector() const
 {
-	return Vector2(-data[1], data[0]);
+	return OldVector2(-data[1], data[0]);
 }
 
-Vector2 &Vector2::operator=(const Vector2 &other)
+OldVector2 &OldVector2::operator=(const OldVector2 &other)
 {
 	data[0] = other.getX();
 	data[1] = other.getY();
@@ -158,41 +158,41 @@ Vector2 &Vector2::operator=(const Vector2 &other)
 
 /* Operators */
 
-const Vector2 Vector2::operator-() const
+const OldVector2 OldVector2::operator-() const
 {
-	return Vector2(-data[0], -data[1]);
+	return OldVector2(-data[0], -data[1]);
 }
 
 
-Vector2 operator*(float a, const Vector2 &vec)
+OldVector2 operator*(float a, const OldVector2 &vec)
 {
-	Vector2 temp(vec.getX() * a, vec.getY() * a);
+	OldVector2 temp(vec.getX() * a, vec.getY() * a);
 	return temp;
 }
 
-Vector2 operator*(const Vector2 &vec, float a)
+OldVector2 operator*(const OldVector2 &vec, float a)
 {
-	Vector2 temp(vec.getX() * a, vec.getY() * a);
+	OldVector2 temp(vec.getX() * a, vec.getY() * a);
 	return temp;
 }
 
-Vector2 operator/(const Vector2 &vec, float a)
+OldVector2 operator/(const OldVector2 &vec, float a)
 {
-	Vector2 temp(vec.getX() / a, vec.getY() / a);
+	OldVector2 temp(vec.getX() / a, vec.getY() / a);
 	return temp;
 }
 
 /* Dot product */
-float operator*(const Vector2 &vec1, const Vector2 &vec2)
+float operator*(const OldVector2 &vec1, const OldVector2 &vec2)
 {
 	return vec1.getX() * vec2.getX() + vec1.getY() * vec2.getY();
 }
 
 /* Cross product */
-float operator^(const Vector2 &vec1, const Vector2 &vec2)
+float operator^(const OldVector2 &vec1, const OldVector2 &vec2)
 {
 	return vec1.getX() * vec2.getY() - vec2.getX() * vec1.getY();
 }
 
-const float *Vector2::getData() const { return data; }
+const float *OldVector2::getData() const { return data; }
 
@@ -0,0 +1,52 @@
+#ifndef _OLDVECTOR2_H_
+#define _OLDVECTOR2_H_
+
+/// The out-of-line Vector2 from before vector2.h went header-only
+/**
+	Kept only so that vector2bench can measure the difference. The code
+	is unchanged apart from the name and the defaulted copy constructor,
+	which newer compilers want next to the user-defined operator=.
+*/
+class OldVector2
+{
+public:
+	OldVector2();
+	OldVector2(float xx, float yy);
+	OldVector2(const OldVector2 &other) = default;
+	
+	void setX(float xx);
+	void setY(float yy);
+
+	float getX() const;
+	float getY() const;
+	float length() const;
+	float angle() const;
+	OldVector2 &rotate(float theta);
+	
+	OldVector2 &normalize();
+	
+	OldVector2 unitVector() const;
+	OldVector2 normalVector() const;
+	
+	OldVector2 operator+(const OldVector2 &vec) const;
+	OldVector2 operator-(const OldVector2 &vec) const;
+	
+	OldVector2 &operator=(const OldVector2 &other);
+	
+	const float *getData() const;
+	
+	/* Vector negation */
+	const OldVector2 operator-() const;
+	
+private:
+	float data[2];
+};
+
+/* Operators */
+extern float operator*(const OldVector2 &vec1, const OldVector2 &vec2);
+extern float operator^(const OldVector2 &vec1, const OldVector2 &vec2);
+extern OldVector2 operator/(const OldVector2 &vec, float a);
+extern OldVector2 operator*(const OldVector2 &vec, float a);
+extern OldVector2 operator*(float a, const OldVector2 &vec);
+
+#endif
@@ -0,0 +1,53 @@
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+
+#include "sim.h"
+
+/*
+	Reports the time of a single Craft::update, the scalar integration
+	step, on crafts hovering over a generated track.
+*/
+
+static const int NUM_CRAFTS = 8;
+static const int NUM_TICKS = 20000;
+static const float DT = 1.0 / 240.0;
+
+int main()
+{
+	World *world = new World();
+	if(world->init() != 0)
+	{
+		fprintf(stderr, "Can't initialize world\n");
+		return 1;
+	}
+	
+	world->generate(1);
+	for(int i = 0; i < NUM_CRAFTS; i++) world->getPlayer(i).setActive(true);
+	world->reset();
+	
+	// let the crafts settle on their beams before measuring
+	for(int i = 0; i < 240; i++) world->update(DT);
+	
+	double total = 0.0;
+	for(int tick = 0; tick < NUM_TICKS; tick++)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		
+		for(int i = 0; i < NUM_CRAFTS; i++) world->getActiveCraft(i).update(DT);
+		
+		total += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		
+		for(int i = 0; i < NUM_CRAFTS; i++)
+		{
+			world->getActiveCraft(i).levelCollide();
+			world->getActiveCraft(i).move();
+		}
+	}
+	
+	printf("Craft::update %.1f ns\n", total * 1e9 / ((double)NUM_TICKS * NUM_CRAFTS));
+	
+	delete world;
+	return 0;
+}
+
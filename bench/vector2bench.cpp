@@ -0,0 +1,180 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <chrono>
+
+#ifdef HAVE_CONFIG_H
+#include "../config.h"
+#endif
+
+#include "vector2.h"
+#include "oldvector2.h"
+
+/*
+	Compares the header-only Vector2 with the old out-of-line one on the
+	two kinds of code where the physics spends its time: craft collision
+	tests and the Runge-Kutta-Nyström integrator. The integrator takes a
+	square root every step, so it shows the effect of --enable-vector2-sse.
+*/
+
+static const int NUM_BOXES = 64;
+static const int COLLISION_ROUNDS = 20000;
+static const int INTEGRATOR_STEPS = 2000000;
+
+struct Box
+{
+	float x, y, angle;
+};
+
+// Level::segmentIsect
+template <class V>
+static bool segmentIsect(const V &v11, const V &v12, const V &v21, const V &v22, V &point)
+{
+	V s1, s2;
+	float s, t;
+
+	s1 = v12 - v11;
+	s2 = v22 - v21;
+	
+	s = (s1 ^ (v11 - v21)) / (s1 ^ s2);
+	t = (s2 ^ (v11 - v21)) / (s1 ^ s2);
+
+	if(s < 0.0 || s > 1.0 || t < 0.0 || t > 1.0) return false;
+	
+	point = v11 + t * s1;
+	return true;
+}
+
+// The vertex transforms and edge tests of Craft::checkCollision
+template <class V>
+static int collide(const Box &a, const Box &b, V &sum)
+{
+	const V corners[4] = {V(-0.25, -0.075), V(0.25, -0.075), V(0.25, 0.075), V(-0.25, 0.075)};
+	V myV[4], otV[4];
+	
+	for(int i = 0; i < 4; i++)
+	{
+		myV[i] = 0.99 * corners[i];
+		myV[i].rotate(a.angle);
+		myV[i] = myV[i] + V(a.x, a.y);
+		
+		otV[i] = corners[i];
+		otV[i].rotate(b.angle);
+		otV[i] = otV[i] + V(b.x, b.y);
+	}
+	
+	int hits = 0;
+	for(int i = 0; i < 4; i++)
+	{
+		for(int j = 0; j < 4; j++)
+		{
+			V point;
+			if(!segmentIsect(myV[i], myV[(i+1)%4], otV[j], otV[(j+1)%4], point)) continue;
+			
+			sum = sum + point;
+			hits++;
+		}
+	}
+	
+	return hits;
+}
+
+// One Craft::integrateRKN step of a damped spring with a unit vector pull
+template <class V>
+static V accel(const V &y, const V &v)
+{
+	return V(0.0, -9.81) - 4.0 * y - 0.25 * v + (y - V(1.0, 0.0)).unitVector();
+}
+
+template <class V>
+static void integrate(V &y, V &v, float dt)
+{
+	V k1, k2, k3, k4;
+	
+	k1 = 0.5 * dt * accel(y, v);
+	V q = 0.5 * dt * (v + 0.5 * k1);
+	k2 = 0.5 * dt * accel(y + q, v + k1);
+	k3 = 0.5 * dt * accel(y + q, v + k2);
+	V l = dt * (v + k3);
+	k4 = 0.5 * dt * accel(y + l, v + 2.0 * k3);
+	
+	y = y + dt * (v + (1.0/3.0) * (k1 + k2 + k3));
+	v = v + (1.0/3.0) * (k1 + 2.0 * k2 + 2.0 * k3 + k4);
+}
+
+template <class V>
+static double benchCollision(const Box *boxes, float &check)
+{
+	V sum;
+	int hits = 0;
+	
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	
+	for(int r = 0; r < COLLISION_ROUNDS; r++)
+	{
+		for(int i = 0; i < NUM_BOXES; i++)
+		{
+			hits += collide(boxes[i], boxes[(i + r) % NUM_BOXES], sum);
+		}
+	}
+	
+	double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	check = sum.getX() + sum.getY() + hits;
+	
+	return t * 1e9 / ((double)COLLISION_ROUNDS * NUM_BOXES);
+}
+
+template <class V>
+static double benchIntegrator(float &check)
+{
+	V y(0.5, 1.0), v(0.0, 0.0);
+	
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	
+	for(int i = 0; i < INTEGRATOR_STEPS; i++) integrate(y, v, 1.0 / 240.0);
+	
+	double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	check = y.getX() + y.getY() + v.getX() + v.getY();
+	
+	return t * 1e9 / INTEGRATOR_STEPS;
+}
+
+static void report(const char *name, double oldNs, double newNs, float oldCheck, float newCheck)
+{
+	printf("%-12s %10.1f %10.1f %8.2fx  %s\n", name, oldNs, newNs, oldNs / newNs,
+		oldCheck == newCheck ? "same result" : "RESULTS DIFFER");
+}
+
+int main()
+{
+	// crafts scattered close enough to each other for plenty of contacts
+	Box boxes[NUM_BOXES];
+	srand(1);
+	for(int i = 0; i < NUM_BOXES; i++)
+	{
+		boxes[i].x = 2.0 * rand() / RAND_MAX;
+		boxes[i].y = 0.5 * rand() / RAND_MAX;
+		boxes[i].angle = 6.28 * rand() / RAND_MAX;
+	}
+	
+	float oldCheck, newCheck;
+	double oldNs, newNs;
+	
+#if defined(VECTOR2_SSE) && defined(__SSE__)
+	printf("Vector2 square roots: SSE\n");
+#else
+	printf("Vector2 square roots: libm\n");
+#endif
+	printf("%-12s %10s %10s %9s\n", "", "old ns", "new ns", "speedup");
+	
+	oldNs = benchCollision<OldVector2>(boxes, oldCheck);
+	newNs = benchCollision<Vector2>(boxes, newCheck);
+	report("collision", oldNs, newNs, oldCheck, newCheck);
+	
+	oldNs = benchIntegrator<OldVector2>(oldCheck);
+	newNs = benchIntegrator<Vector2>(newCheck);
+	report("integrator", oldNs, newNs, oldCheck, newCheck);
+	
+	return 0;
+}
+
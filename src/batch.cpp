@@ -0,0 +1,447 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <vector>
+
+#include <getopt.h>
+
+#include "sim.h"
+
+/*
+	antigrav-batch runs a matrix of headless races (seed x player count x
+	bot profile) on all cores and writes the results as CSV or JSON. It
+	can record the races as replays, and run recorded replays instead.
+*/
+
+// reported for races driven by a replay
+static const Bot::Profile REPLAY_PROFILE = {"replay", 0.0, 0.0, 0.0};
+
+static const int MAX_PLAYERS = 1000;
+
+struct Race
+{
+	int seed;
+	int players;
+	const Bot::Profile *profile;
+	Replay *replay;		// controls to play instead of the bots, or NULL
+	
+	bool failed;		// the world couldn't be set up, there are no results
+	int ticks;
+	int steps;
+	double simTime;
+	double wallTime;
+	std::vector<double> finishTime;
+	std::vector<float> distance;
+	unsigned int hash;	// of the final state
+};
+
+struct Batch
+{
+	std::vector<Race> races;
+	float rate;
+	float timeLimit;
+	int integrator;
+	int maxSubSteps;
+	float tolerance;
+	const char *recordPrefix;
+	const char *logPrefix;
+	const char *ghostPrefix;
+	bool splitRaces;
+	WorkerPool *pool;	// runs the races, and their parts when they are split
+};
+
+const char *help_msg =
+"Usage: antigrav-batch [options] [REPLAY...]\n\
+Runs the recorded races when replay files are given, the seed, player and\n\
+bot options are ignored then.\n\
+Options:\n\
+  -h, --help\t\tprint this help, then exit\n\
+  -s, --seeds=A[-B]\trace on level seeds A to B (default 1)\n\
+  -p, --players=LIST\tcomma separated player counts (default 1)\n\
+  -b, --bots=LIST\tcomma separated bot profiles (default boost)\n\
+  -j, --jobs=N\t\trun N races in parallel (default one per core)\n\
+  -c, --split-races\tgenerate the levels and integrate the crafts as jobs too\n\
+  -r, --rate=HZ\t\tsimulation tick rate (default 240)\n\
+  -m, --max-substeps=N\tsplit ticks into up to N steps near the track (default 8)\n\
+  -i, --integrator=NAME\tscalar, batch or adaptive (default batch)\n\
+  -e, --tolerance=TOL\tlocal error allowed by the adaptive integrator (default 0.001)\n\
+  -t, --time-limit=SEC\tgive up on a race after SEC seconds (default 300)\n\
+  -f, --format=FMT\toutput csv or json (default csv)\n\
+  -o, --output=FILE\twrite results to FILE instead of stdout\n\
+  -R, --record=PREFIX\tsave the controls of race N to PREFIXN.rpl\n\
+  -L, --state-log=PREFIX\tlog the state of race N at every tick to PREFIXN.slog\n\
+  -g, --ghost=PREFIX\tsave the poses of the first craft of race N to PREFIXN.ghost\n";
+
+static void runRace(int n, void *arg)
+{
+	Batch *batch = (Batch *)arg;
+	Race &race = batch->races[n];
+	
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	
+	World *world = new World();
+	race.failed = world->init() != 0;
+	if(race.failed)
+	{
+		fprintf(stderr, "Can't initialize race %d\n", n);
+		delete world;
+		return;
+	}
+	
+	// the parts of a race are jobs on the same pool as the races
+	world->setWorkerPool(batch->splitRaces ? batch->pool : NULL);
+	
+	float dt = 1.0 / batch->rate;
+	int maxTicks = (int)(batch->timeLimit * batch->rate);
+	
+	if(race.replay != NULL)
+	{
+		race.replay->setup(*world);
+		dt = race.replay->getDt();
+		maxTicks = race.replay->getTicks();
+	} else
+	{
+		world->setIntegrator(batch->integrator);
+		world->setMaxSubSteps(batch->maxSubSteps);
+		world->setTolerance(batch->tolerance);
+		world->generate(race.seed);
+		world->setNumPlayers(race.players);
+		for(int i = 0; i < race.players; i++) world->getPlayer(i).setActive(true);
+	}
+	world->reset();
+	const int numActive = world->getActivePlayers();
+	
+	Replay recording;
+	if(batch->recordPrefix != NULL) recording.start(*world, dt);
+	
+	StateLog log;
+	if(batch->logPrefix != NULL)
+	{
+		char filename[1024];
+		snprintf(filename, sizeof(filename), "%s%d.slog", batch->logPrefix, n);
+		log.open(filename, *world);
+	}
+	
+	Ghost ghost;
+	if(batch->ghostPrefix != NULL)
+	{
+		char filename[1024];
+		snprintf(filename, sizeof(filename), "%s%d.ghost", batch->ghostPrefix, n);
+		ghost.create(filename, dt);
+		if(numActive > 0) ghost.record(world->getActiveCraft(0));
+	}
+	
+	std::vector<Bot> bots(race.players);
+	for(int i = 0; i < race.players && race.replay == NULL; i++) bots[i].reset(*race.profile, race.seed, i);
+	
+	race.ticks = 0;
+	while(race.ticks < maxTicks && world->getFinishedPlayers() < numActive)
+	{
+		if(race.replay != NULL)
+		{
+			race.replay->play(*world);
+		} else
+		{
+			for(int i = 0; i < race.players; i++) bots[i].drive(world->getPlayer(i).getCraft(), world->getLevel());
+		}
+		
+		if(batch->recordPrefix != NULL) recording.record(*world);
+		
+		world->update(dt);
+		log.record(*world);
+		if(numActive > 0) ghost.record(world->getActiveCraft(0));
+		race.ticks++;
+	}
+	
+	log.close();
+	ghost.close();
+	
+	if(batch->recordPrefix != NULL)
+	{
+		char filename[1024];
+		snprintf(filename, sizeof(filename), "%s%d.rpl", batch->recordPrefix, n);
+		recording.save(filename);
+	}
+	
+	race.hash = StateLog::hash(*world);
+	race.steps = world->getSubSteps();
+	race.simTime = world->getTime();
+	race.finishTime.resize(race.players);
+	race.distance.resize(race.players);
+	for(int i = 0; i < race.players; i++)
+	{
+		race.finishTime[i] = world->getPlayer(i).getFinishTime();
+		race.distance[i] = world->getPlayer(i).getCraft().getPos().getX();
+	}
+	
+	delete world;
+	
+	race.wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Split a comma separated list in place
+static std::vector<char *> splitList(char *list)
+{
+	std::vector<char *> items;
+	for(char *item = strtok(list, ","); item; item = strtok(NULL, ",")) items.push_back(item);
+	return items;
+}
+
+static void writeCsv(FILE *out, const Batch &batch)
+{
+	fprintf(out, "race,seed,players,profile,player,finished,finish_time,distance,ticks,steps,sim_time,hash,wall_ms\n");
+	
+	for(unsigned int r = 0; r < batch.races.size(); r++)
+	{
+		const Race &race = batch.races[r];
+		for(int i = 0; i < race.players && !race.failed; i++)
+		{
+			fprintf(out, "%u,%d,%d,%s,%d,%d,%.4f,%.4f,%d,%d,%.4f,%08x,%.3f\n", r, race.seed, race.players,
+				race.profile->name, i, race.finishTime[i] >= 0.0, race.finishTime[i],
+				race.distance[i], race.ticks, race.steps, race.simTime, race.hash, race.wallTime * 1000.0);
+		}
+	}
+}
+
+static void writeJson(FILE *out, const Batch &batch)
+{
+	fprintf(out, "[");
+	
+	const char *separator = "\n";
+	for(unsigned int r = 0; r < batch.races.size(); r++)
+	{
+		const Race &race = batch.races[r];
+		if(race.failed) continue;
+		
+		fprintf(out, "%s  {\"race\": %u, \"seed\": %d, \"players\": %d, \"profile\": \"%s\", "
+			"\"ticks\": %d, \"steps\": %d, \"sim_time\": %.4f, \"hash\": \"%08x\", \"wall_ms\": %.3f, \"finish_times\": [",
+			separator, r, race.seed, race.players, race.profile->name,
+			race.ticks, race.steps, race.simTime, race.hash, race.wallTime * 1000.0);
+		
+		for(int i = 0; i < race.players; i++)
+		{
+			if(i > 0) fprintf(out, ", ");
+			if(race.finishTime[i] >= 0.0) fprintf(out, "%.4f", race.finishTime[i]);
+			else fprintf(out, "null");
+		}
+		
+		fprintf(out, "], \"distances\": [");
+		
+		for(int i = 0; i < race.players; i++)
+		{
+			fprintf(out, "%s%.4f", i > 0 ? ", " : "", race.distance[i]);
+		}
+		
+		fprintf(out, "]}");
+		separator = ",\n";
+	}
+	
+	fprintf(out, "\n]\n");
+}
+
+int main(int argc, char *argv[])
+{
+	int firstSeed = 1, lastSeed = 1;
+	int jobs = 0;
+	bool json = false;
+	const char *output = NULL;
+	char defaultPlayers[] = "1", defaultBots[] = "boost";
+	char *playerList = defaultPlayers, *botList = defaultBots;
+	
+	Batch batch;
+	batch.rate = 240.0;
+	batch.timeLimit = 300.0;
+	batch.integrator = World::INTEGRATE_BATCH;
+	batch.maxSubSteps = 8;
+	batch.tolerance = 1e-3;
+	batch.recordPrefix = NULL;
+	batch.logPrefix = NULL;
+	batch.ghostPrefix = NULL;
+	batch.splitRaces = false;
+	
+	while(true)
+	{
+		int option_index = 0;
+		static struct option long_options[] = {
+			{"help", no_argument, 0, 'h'},
+			{"seeds", required_argument, 0, 's'},
+			{"players", required_argument, 0, 'p'},
+			{"bots", required_argument, 0, 'b'},
+			{"jobs", required_argument, 0, 'j'},
+			{"split-races", no_argument, 0, 'c'},
+			{"rate", required_argument, 0, 'r'},
+			{"max-substeps", required_argument, 0, 'm'},
+			{"time-limit", required_argument, 0, 't'},
+			{"integrator", required_argument, 0, 'i'},
+			{"tolerance", required_argument, 0, 'e'},
+			{"format", required_argument, 0, 'f'},
+			{"output", required_argument, 0, 'o'},
+			{"record", required_argument, 0, 'R'},
+			{"state-log", required_argument, 0, 'L'},
+			{"ghost", required_argument, 0, 'g'},
+			{0, 0, 0, 0}
+		};
+		
+		int c = getopt_long(argc, argv, "hs:p:b:j:cr:m:t:i:e:f:o:R:L:g:", long_options, &option_index);
+		if(c == -1)
+			break;
+		
+		switch(c)
+		{
+			case 'h':
+				fputs(help_msg, stdout);
+				return 0;
+			case 's':
+				if(sscanf(optarg, "%d-%d", &firstSeed, &lastSeed) < 2) lastSeed = firstSeed;
+				break;
+			case 'p':
+				playerList = optarg;
+				break;
+			case 'b':
+				botList = optarg;
+				break;
+			case 'j':
+				jobs = atoi(optarg);
+				break;
+			case 'c':
+				batch.splitRaces = true;
+				break;
+			case 'r':
+				batch.rate = atof(optarg);
+				break;
+			case 'm':
+				batch.maxSubSteps = atoi(optarg);
+				break;
+			case 't':
+				batch.timeLimit = atof(optarg);
+				break;
+			case 'i':
+				if(strcmp(optarg, "scalar") == 0) batch.integrator = World::INTEGRATE_SCALAR;
+				else if(strcmp(optarg, "batch") == 0) batch.integrator = World::INTEGRATE_BATCH;
+				else if(strcmp(optarg, "adaptive") == 0) batch.integrator = World::INTEGRATE_ADAPTIVE;
+				else
+				{
+					fprintf(stderr, "Unknown integrator %s\n", optarg);
+					return 1;
+				}
+				break;
+			case 'e':
+				batch.tolerance = atof(optarg);
+				break;
+			case 'f':
+				if(strcmp(optarg, "json") == 0) json = true;
+				else if(strcmp(optarg, "csv") == 0) json = false;
+				else
+				{
+					fprintf(stderr, "Unknown format %s\n", optarg);
+					return 1;
+				}
+				break;
+			case 'o':
+				output = optarg;
+				break;
+			case 'R':
+				batch.recordPrefix = optarg;
+				break;
+			case 'L':
+				batch.logPrefix = optarg;
+				break;
+			case 'g':
+				batch.ghostPrefix = optarg;
+				break;
+			default:
+				fputs(help_msg, stderr);
+				return 1;
+		}
+	}
+	
+	if(batch.rate <= 0.0 || lastSeed < firstSeed)
+	{
+		fputs(help_msg, stderr);
+		return 1;
+	}
+	
+	// replays given on the command line replace the race matrix
+	std::vector<Replay> replays(argc - optind);
+	for(int i = optind; i < argc; i++)
+	{
+		Replay &replay = replays[i - optind];
+		if(replay.load(argv[i]) != 0) return 1;
+		
+		Race race;
+		race.seed = replay.getSeed();
+		race.players = replay.getNumPlayers();
+		race.profile = &REPLAY_PROFILE;
+		race.replay = &replay;
+		batch.races.push_back(race);
+	}
+	
+	// build the race matrix
+	std::vector<char *> players = splitList(playerList);
+	std::vector<char *> bots = splitList(botList);
+	
+	for(int seed = firstSeed; seed <= lastSeed && replays.empty(); seed++)
+	{
+		for(unsigned int p = 0; p < players.size(); p++)
+		{
+			for(unsigned int b = 0; b < bots.size(); b++)
+			{
+				Race race;
+				race.seed = seed;
+				race.players = atoi(players[p]);
+				race.profile = Bot::findProfile(bots[b]);
+				race.replay = NULL;
+				
+				if(race.players < 1 || race.players > MAX_PLAYERS)
+				{
+					fprintf(stderr, "Player count must be between 1 and %d\n", MAX_PLAYERS);
+					return 1;
+				}
+				
+				if(race.profile == NULL)
+				{
+					fprintf(stderr, "Unknown bot profile %s\n", bots[b]);
+					return 1;
+				}
+				
+				batch.races.push_back(race);
+			}
+		}
+	}
+	
+	FILE *out = stdout;
+	if(output != NULL)
+	{
+		out = fopen(output, "w");
+		if(out == NULL)
+		{
+			fprintf(stderr, "Can't open %s\n", output);
+			return 1;
+		}
+	}
+	
+	WorkerPool pool(jobs);
+	batch.pool = &pool;
+	
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	pool.run(batch.races.size(), runRace, &batch);
+	double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	
+	if(json) writeJson(out, batch);
+	else writeCsv(out, batch);
+	
+	if(out != stdout) fclose(out);
+	
+	fprintf(stderr, "%u races on %d threads in %.2f s\n", (unsigned int)batch.races.size(), pool.getNumThreads(), elapsed);
+	
+	// the races that could be set up are reported anyway
+	for(unsigned int r = 0; r < batch.races.size(); r++)
+	{
+		if(batch.races[r].failed) return 1;
+	}
+	
+	return 0;
+}
+
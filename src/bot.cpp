@@ -0,0 +1,84 @@
+#include <cmath>
+#include <cstring>
+
+#include "sim.h"
+
+const Bot::Profile Bot::PROFILES[] = {
+	{"cruise", 0.25, 0.6, 2.0},
+	{"boost", 0.25, 0.3, 0.3},
+	{"reckless", 0.35, 0.3, 0.0},
+};
+const int Bot::NUM_PROFILES = sizeof(PROFILES) / sizeof(PROFILES[0]);
+
+const float Bot::DEADBAND = 0.02;
+const float Bot::LOOK_AHEAD = 2.0;
+const float Bot::LEAN_SPREAD = 0.05;
+const float Bot::FUEL_SPREAD = 0.1;
+
+/// Find a profile by name
+/**
+	@return the profile, or NULL if there is none by that name
+*/
+const Bot::Profile *Bot::findProfile(const char *name)
+{
+	for(int i = 0; i < NUM_PROFILES; i++)
+	{
+		if(strcmp(PROFILES[i].name, name) == 0) return &PROFILES[i];
+	}
+	
+	return NULL;
+}
+
+Bot::Bot()
+{
+	reset(PROFILES[0], 0, 0);
+}
+
+/// Get ready for a race
+/**
+	@param profile	the driving style
+	@param seed	usually the level seed
+	@param player	the slot the bot drives, so that bots in the same race
+			differ
+*/
+void Bot::reset(const Profile &p, int seed, int player)
+{
+	rng = fnvHash(fnvHash(FNV_BASIS, &seed, sizeof(seed)), &player, sizeof(player));
+	if(rng == 0) rng = 1;
+	boosting = false;
+	
+	profile = p;
+	profile.lean += LEAN_SPREAD * (2.0 * random() - 1.0);
+	profile.boostFuel += FUEL_SPREAD * (2.0 * random() - 1.0);
+}
+
+/// Set the controls for the next tick
+/**
+	Holds the profile's lean angle and boosts in bursts.
+*/
+void Bot::drive(Craft &craft, const Level &level)
+{
+	// the controls set the angular acceleration, so steer on a
+	// damped angle error to avoid overshooting into a flip. Tilting
+	// back for upcoming climbs keeps the beam on the ground.
+	float climb = 0.5 * atan(level.getSlope(craft.getPos().getX() + LOOK_AHEAD));
+	float error = craft.getAngle() + profile.lean - climb + profile.damping * craft.getOmega();
+	
+	craft.setControl(Craft::CTRL_CW, error > DEADBAND);
+	craft.setControl(Craft::CTRL_CCW, error < -DEADBAND);
+	
+	if(craft.getBoostFuel() <= 0.0) boosting = false;
+	else if(craft.getBoostFuel() >= profile.boostFuel) boosting = true;
+	craft.setControl(Craft::CTRL_BOOST, boosting);
+}
+
+const Bot::Profile &Bot::getProfile() const { return profile; }
+
+// xorshift, in [0, 1)
+float Bot::random()
+{
+	rng ^= rng << 13;
+	rng ^= rng >> 17;
+	rng ^= rng << 5;
+	return (rng >> 8) / 16777216.0f;
+}
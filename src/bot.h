@@ -0,0 +1,49 @@
+#ifndef _BOT_H_
+#define _BOT_H_
+
+/// A computer driver
+/**
+	A bot sets the controls of a craft from its state and the slope of
+	the track ahead, like a player at the keyboard would. Its behaviour
+	comes from a profile, varied a little per bot from a seed, so that a
+	field of bots spreads out but every race with the same seeds is
+	driven the same way.
+*/
+class Bot
+{
+public:
+	/// A driving style
+	struct Profile
+	{
+		const char *name;
+		float lean;		// target lean angle in radians
+		float damping;		// how much the turn rate is taken into account
+		float boostFuel;	// start boosting when the tank is this full
+	};
+
+	static const Profile PROFILES[];
+	static const int NUM_PROFILES;
+
+	static const Profile *findProfile(const char *name);
+
+	Bot();
+
+	void reset(const Profile &profile, int seed, int player);
+	void drive(Craft &craft, const Level &level);
+
+	const Profile &getProfile() const;
+
+private:
+	static const float DEADBAND;
+	static const float LOOK_AHEAD;
+	static const float LEAN_SPREAD;
+	static const float FUEL_SPREAD;
+
+	float random();
+
+	Profile profile;
+	bool boosting;
+	unsigned int rng;
+};
+
+#endif
@@ -1,38 +1,7 @@
-#include "SDL_opengl.h"
 #include <cmath>
 #include <cstdio>
 
-#include <AL/al.h>
-
-#include "antigrav.h"
-
-CraftState::CraftState() : pos(0.0, 0.0), angle(0.0) { }
-
-CraftState::CraftState(const Vector2& p, float a)
-{
-	pos = p;
-	angle = a;
-}
-
-const Vector2& CraftState::getPos() const { return pos; }
-float CraftState::getAngle() const { return angle; }
-
-CraftState operator+(const CraftState& s1, const CraftState& s2)
-{
-	return CraftState(s1.getPos() + s2.getPos(), s1.getAngle() + s2.getAngle());
-}
-
-CraftState operator*(float f, const CraftState& s2)
-{
-	return CraftState(f * s2.getPos(), f * s2.getAngle());
-}
-
-void CraftState::setPos(const Vector2 &p) { pos = p; }
-void CraftState::setAngle(float a) { angle = a; }
-
-float CraftState::getX() const { return pos.getX(); }
-float CraftState::getY() const { return pos.getY(); }
-
+#include "sim.h"
 
 const float Craft::TURN_RATE = 3.14;
 const float Craft::TURN_DAMP = 1.0;
@@ -45,6 +14,7 @@ const float Craft::DAMP = 0.25;
 
 const float Craft::HEIGHT = 0.15;
 const float Craft::WIDTH = 0.5;
+const float Craft::RADIUS = 0.5 * sqrt(HEIGHT * HEIGHT + WIDTH * WIDTH);
 const float Craft::MASS = 1.0;
 const float Craft::INERTIA = 1.0 / 12.0 * MASS * (HEIGHT * HEIGHT + WIDTH * WIDTH);
 
@@ -59,7 +29,7 @@ const float Craft::MINOR_AXIS = 0.075;
 const float Craft::BOUNCYNESS = 0.5;
 const float Craft::LEVEL_BOUNCYNESS = 0.5;
 
-m3dMesh Craft::mesh;
+const float Craft::PARALLEL = 0.05;
 
 Craft::Craft()
 {
@@ -80,37 +50,183 @@ Craft::Craft()
 	
 	boostFuel = 1.0;
     ringTimer = 0;
+	hoverForce = 0.0;
+	force = Vector2(0.0, 0.0);
+	pushTarget = -1;
+	boxAxis = Vector2(1.0, 0.0);
+	
+	for(int i = 0; i < NUM_CONTROLS; i++) ctrl[i] = false;
+	
+	world = NULL;
+	
+	adaptiveStep = 0.0;
+	derives = 0;
+	batchSync = BATCH_STALE;
 }
 
-template <class T> void Craft::integrateRKN(float x0, T y0, T dy0, float dx, T *y, T *dy)
+void Craft::setWorld(World *w)
 {
+	world = w;
+}
+
+/// One Runge-Kutta-Nyström step
+/**
+	Computes the same sums as the textbook form
+	k1 = h/2 f(y0, v0), k2 = h/2 f(y0 + h/2 (v0 + k1/2), v0 + k1), ...
+	in the same order, but builds every stage in place.
+*/
+template <class T> void Craft::integrateRKN(float x0, const T &y0, const T &dy0, float dx, T *y, T *dy)
+{
+	const float h2 = 0.5 * dx;
+	const float third = 1.0 / 3.0;
 	T k1, k2, k3, k4;
-	T l;
+	T sy, sv;
+	
+	HoverBeam hover;
+	k1 = derive(x0, y0, dy0, &hover);
+	k1 *= h2;
+	setBeam(hover);
+	
+	sy.setSum(dy0, 0.5, k1);
+	sy *= h2;
+	sy += y0;
+	sv.setSum(dy0, 1.0, k1);
+	k2 = derive(x0 + h2, sy, sv);
+	k2 *= h2;
+	
+	sv.setSum(dy0, 1.0, k2);
+	k3 = derive(x0 + h2, sy, sv);
+	k3 *= h2;
+	
+	sy.setSum(dy0, 1.0, k3);
+	sy *= dx;
+	sy += y0;
+	sv.setSum(dy0, 2.0, k3);
+	k4 = derive(x0 + dx, sy, sv);
+	k4 *= h2;
+	derives += 4;
+	
+	// y = h (v0 + (k1 + k2 + k3) / 3)
+	sy = k1;
+	sy += k2;
+	sy += k3;
+	y->setSum(dy0, third, sy);
+	*y *= dx;
+	
+	// v = v0 + (k1 + 2 k2 + 2 k3 + k4) / 3
+	sv.setSum(k1, 2.0, k2);
+	sv.addScaled(2.0, k3);
+	sv += k4;
+	dy->setSum(dy0, third, sv);
+}
+
+// Largest component of a state
+static float maxAbs(const CraftState &s)
+{
+	return MAX(MAX(ABS(s.getX()), ABS(s.getY())), ABS(s.getAngle()));
+}
+
+/// Error controlled integration over dt with the Bogacki-Shampine 3(2) pair
+/**
+	Takes as many steps as needed to keep the estimated local error of
+	each step below tolerance, but never shorter than dt /
+	MAX_ADAPTIVE_STEPS. The step size that worked is remembered for the
+	next tick, so a craft cruising in free flight makes one step per tick
+	and one close to the track or other crafts makes several.
+	The state is written to delta and dState like integrateRKN does.
+*/
+void Craft::integrateAdaptive(float dt, float tolerance)
+{
+	const float minStep = dt / MAX_ADAPTIVE_STEPS;
+	CraftState y = state, v = dState;
+	CraftState y2, v2, y3, v3, y4, v4, a2, a3, a4, ey, ev;
 	
-	k1 = 0.5 * dx * derive(x0, y0, dy0);
-	l = 0.5 * dx * (dy0 + 0.5 * k1);
-	k2 = 0.5 * dx * derive(x0 + 0.5 * dx, y0 + l, dy0 + k1);
-	k3 = 0.5 * dx * derive(x0 + 0.5 * dx, y0 + l, dy0 + k2);
-	l = dx * (dy0 + k3);
-	k4 = 0.5 * dx * derive(x0 + dx, y0 + l, dy0 + 2.0 * k3);
+	float h = adaptiveStep > 0.0 ? adaptiveStep : dt;
+	float t = 0.0, left = dt;
 	
-	*y = dx * (dy0 + (1.0/3.0) * (k1 + k2 + k3));
-	*dy = dy0 + (1.0/3.0) * (k1 + 2.0 * k2 + 2.0 * k3 + k4);
+	HoverBeam hover;
+	CraftState a1 = derive(t, y, v, &hover);
+	setBeam(hover);
+	derives++;
+	
+	while(left > 0.0)
+	{
+		float step = MIN(h, left);
+		
+		y2.setSum(y, 0.5 * step, v);
+		v2.setSum(v, 0.5 * step, a1);
+		a2 = derive(t + 0.5 * step, y2, v2);
+		
+		y3.setSum(y, 0.75 * step, v2);
+		v3.setSum(v, 0.75 * step, a2);
+		a3 = derive(t + 0.75 * step, y3, v3);
+		
+		// third order solution
+		y4.setSum(y, step * (2.0/9.0), v);
+		y4.addScaled(step * (1.0/3.0), v2);
+		y4.addScaled(step * (4.0/9.0), v3);
+		v4.setSum(v, step * (2.0/9.0), a1);
+		v4.addScaled(step * (1.0/3.0), a2);
+		v4.addScaled(step * (4.0/9.0), a3);
+		a4 = derive(t + step, y4, v4);
+		derives += 3;
+		
+		// difference to the embedded second order solution
+		ey = (step * (-5.0/72.0)) * v;
+		ey.addScaled(step * (1.0/12.0), v2);
+		ey.addScaled(step * (1.0/9.0), v3);
+		ey.addScaled(step * (-1.0/8.0), v4);
+		ev = (step * (-5.0/72.0)) * a1;
+		ev.addScaled(step * (1.0/12.0), a2);
+		ev.addScaled(step * (1.0/9.0), a3);
+		ev.addScaled(step * (-1.0/8.0), a4);
+		
+		float error = MAX(maxAbs(ey), maxAbs(ev));
+		
+		if(error <= tolerance || step <= minStep)
+		{
+			y = y4;
+			v = v4;
+			a1 = a4;
+			t += step;
+			left = step < left ? left - step : 0.0;
+		}
+		
+		float scale = error > 0.0 ? 0.9 * pow(tolerance / error, 1.0 / 3.0) : 5.0;
+		h = MAX(step * MIN(MAX(scale, 0.2), 5.0), minStep);
+	}
+	
+	delta.setSum(y, -1.0, state);
+	dState = v;
+	adaptiveStep = MIN(h, dt);
+	batchSync = BATCH_STALE;
 }
 
-CraftState Craft::derive(float t, const CraftState &s, const CraftState &ds)
+/// Accelerations of the craft in a given state
+/**
+	Only reads the craft and the world, so the crafts can be integrated
+	in parallel. The forces from other crafts' beams are the ones
+	gathered in the previous step.
+	@param hover	if not NULL, receives the hover beam of this state
+*/
+CraftState Craft::derive(float t, const CraftState &s, const CraftState &ds, HoverBeam *hover) const
 {
 	CraftState result;
+	Vector2 beam[2];
 	
 	(void)t;
 	
-	beam[0] = Vector2(getPos());
-	beam[1] = Vector2(s.getPos().getY() * tan(s.getAngle()), -s.getPos().getY());
-	beam[0] = beam[0] + beam[1].unitVector() * 0.55 * HEIGHT;
-	beam[1] = beam[1] + beam[0] -  beam[1].unitVector() * 0.55 * HEIGHT;
+	beam[0] = s.getPos();
+	beam[1] = Vector2(s.getPos().getY() * SIM_TAN(s.getAngle()), -s.getPos().getY());
+	
+	// the force acts along the beam, which has no length when it
+	// starts right on the track
+	Vector2 dir = beam[1].unitVector();
+	beam[0] = beam[0] + dir * 0.55 * HEIGHT;
+	beam[1] = beam[1] + beam[0] - dir * 0.55 * HEIGHT;
 	
 	Vector2 temp;
-	if(Game::getInstance().getLevel().intersect(beam[0], beam[1], temp))
+	if(world->getLevel().castBeam(beam[0], beam[1], temp))
 	{
 		beam[1] = temp;
 	}
@@ -118,13 +234,19 @@ CraftState Craft::derive(float t, const CraftState &s, const CraftState &ds)
 	bool inverted = false;
 	if(s.getAngle() < -M_PI/2.0 || s.getAngle() > M_PI/2.0) inverted = true;
 	
-	Vector2 l = beam[1] - beam[0];
-	float d = l.length();
+	float d = (beam[1] - beam[0]).length();
+	
+	// only crafts whose centre is within half a craft of the beam can be hit
+	const CraftGrid &grid = world->getCraftGrid();
+	int first, last;
+	grid.query(MIN(beam[0].getX(), beam[1].getX()) - 0.5 * WIDTH,
+		MAX(beam[0].getX(), beam[1].getX()) + 0.5 * WIDTH, first, last);
 	
 	int numCraft = -1;
-	for(int i = 0; i < Game::MAX_PLAYERS; i++)
+	for(int k = first; k < last; k++)
 	{
-		Craft &craft = Game::getInstance().getPlayer(i).getCraft();
+		int i = grid.getItem(k);
+		Craft &craft = world->getActiveCraft(i);
 		Vector2 point;
 		
 		if(craft.beamIntersect(beam[0], beam[1], point))
@@ -139,22 +261,24 @@ CraftState Craft::derive(float t, const CraftState &s, const CraftState &ds)
 		}
 	}
 	
-	l = beam[1] - beam[0];
-	d = exp(-d + 1) * HOVER_FORCE;
+	d = SIM_EXP(-d + 1) * HOVER_FORCE;
 	
 	if(inverted) d *= INVERTED_FORCE_MOD;
 	
 	// Boost
 	if(ctrl[CTRL_BOOST] && boostFuel > 0.0 && !inverted) d *= BOOST;
 	
-	hoverForce = d;
-	
-	Vector2 fce = l.unitVector() * d;
-	if(numCraft != -1) Game::getInstance().getPlayer(numCraft).getCraft().addForce(fce);
+	if(hover != NULL)
+	{
+		hover->start = beam[0];
+		hover->end = beam[1];
+		hover->force = d;
+		hover->target = numCraft;
+		hover->push = dir * d;
+	}
 
 	// set velocity vector
-	result.setPos(Vector2(0.0, GRAVITY) - l.unitVector() * d - DAMP * ds.getPos() + force);
-	force = Vector2(0.0,0.0);
+	result.setPos(Vector2(0.0, GRAVITY) - dir * d - DAMP * ds.getPos() + force);
 	
 	// Turning
 	if(ctrl[CTRL_CCW]) result.setAngle(TURN_RATE);
@@ -164,7 +288,41 @@ CraftState Craft::derive(float t, const CraftState &s, const CraftState &ds)
 	return result;
 }
 
+// Remember the beam at the start of a step, for drawing, rings and the
+// push on other crafts
+void Craft::setBeam(const HoverBeam &hover)
+{
+	beam[0] = hover.start;
+	beam[1] = hover.end;
+	hoverForce = hover.force;
+	pushTarget = hover.target;
+	push = hover.push;
+}
+
 void Craft::update(float dt)
+{
+	prepare(dt);
+	integrate(dt);
+}
+
+/// Integrate over dt without the per tick work of prepare()
+/**
+	Only writes to this craft, see derive().
+*/
+void Craft::integrate(float dt)
+{
+	integrateRKN<CraftState>(0.0f, state, dState, dt, &delta, &dState);
+	batchSync = BATCH_STALE;
+}
+
+void Craft::updateAdaptive(float dt, float tolerance)
+{
+	prepare(dt);
+	integrateAdaptive(dt, tolerance);
+}
+
+// Per tick work that has to happen before the integration step
+void Craft::prepare(float dt)
 {
     bool boost = false;
 	// boost
@@ -185,18 +343,31 @@ void Craft::update(float dt)
     if(ringTimer > ((boost)?0.20:0.4)) {
         if(getAngle() > -M_PI/4.0 && getAngle() < M_PI/4.0 && (beam[1]-beam[0]).length()<3.0) {
             Vector2 vel((beam[1]-beam[0]).unitVector()*2);
-            Ring::addRing(Ring(getX(),getY(),getAngle(),vel+getVel(),color));
+            world->getRings().add(Ring(getX(),getY(),getAngle(),vel+getVel(),color));
             ringTimer = 0;
         }
     }
 
-	integrateRKN<CraftState>(0.0f, state, dState, dt, &delta, &dState);
+	saveState();
 }
 
+// Remember the current state as the start point of render interpolation
+void Craft::saveState()
+{
+	prevState = state;
+}
+
+/// Apply the step's position delta
+/**
+	A craft moved right after CraftBatch integrated it is where the
+	batch's planes put it, any other change makes the batch load it again.
+*/
 void Craft::move()
 {
 	state = state + delta;
+	batchSync = batchSync == BATCH_INTEGRATED ? BATCH_MOVED : BATCH_STALE;
 	
+	if(state.getAngle() > M_PI || state.getAngle() < -M_PI) batchSync = BATCH_STALE;
 	while(state.getAngle() > M_PI) state.setAngle(state.getAngle() - 2.0 * M_PI);
 	while(state.getAngle() < -M_PI) state.setAngle(state.getAngle() + 2.0 * M_PI);
 }
@@ -206,6 +377,11 @@ void Craft::setControl(int control, bool value)
 	ctrl[control] = value;
 }
 
+bool Craft::getControl(int control) const
+{
+	return ctrl[control];
+}
+
 void Craft::setColor(float r, float g, float b)
 {
     color[0] = r;
@@ -213,66 +389,6 @@ void Craft::setColor(float r, float g, float b)
     color[2] = b;
 }
 
-void Craft::draw3d()
-{
-	glPushMatrix();
-	
-	glTranslatef(state.getPos().getX(), state.getPos().getY(), 0.0);
-	glRotatef(DEG(state.getAngle()), 0.0, 0.0, 1.0);
-	
-	// draw 3d mesh
-	glEnable(GL_TEXTURE_2D);
-	mesh.draw();
-	glDisable(GL_TEXTURE_2D);
-	
-	glPopMatrix();
-	
-#if 0
-	// draw beam
-	if(state.getAngle() > -M_PI / 2.0 && state.getAngle() < M_PI / 2.0)
-	{
-		glDisable(GL_LIGHTING);
-		glBegin(GL_LINES);
-		glVertex2fv(beam[0].getData());
-		glVertex2fv(beam[1].getData());
-		glEnd();
-		glEnable(GL_LIGHTING);
-	}
-#endif
-}
-
-void Craft::draw2d()
-{
-	glPushMatrix();
-	
-	glTranslatef(state.getPos().getX(), state.getPos().getY(), 0.0);
-	glRotatef(DEG(state.getAngle()), 0.0, 0.0, 1.0);
-	
-	// draw bounding ellipse
-	glBegin(GL_LINE_LOOP);
-	for(int i = 0; i < 16; i++)
-	{
-		glVertex2f(cos((float) i / 16.0 * 2.0 * M_PI) * majorAxis, sin((float) i / 16.0 * 2.0 * M_PI) * minorAxis);
-	}
-	glEnd();
-	
-	// draw bounding box
-	glBegin(GL_LINE_LOOP);
-	for(int i = 0; i < 4; i++)
-	{
-		glVertex2fv(vertices[i].getData());
-	}
-	glEnd();
-	
-	glPopMatrix();
-
-	// draw beam
-	glBegin(GL_LINES);
-	glVertex2fv(beam[0].getData());
-	glVertex2fv(beam[1].getData());
-	glEnd();
-}
-
 bool Craft::collide(Craft &other)
 {
 	Vector2 normal, point;
@@ -283,57 +399,82 @@ bool Craft::collide(Craft &other)
 	return true;
 }
 
+/// Cache the collision box for this tick
+/**
+	The box is where the craft will be after move(). World::collideCrafts
+	calls this before testing pairs, and it must be called again when the
+	craft is moved by other means before checkCollision().
+*/
+void Craft::updateBox()
+{
+	float angle = getAngle() + getDAngle();
+	boxCenter = getPos() + getDPos();
+	boxAxis = Vector2(cos(angle), sin(angle));
+}
+
+/// Test for overlap with another craft
+/**
+	Rejects on bounding circles first, then runs a separating axis test
+	on the two boxes cached by updateBox(). The axis of least overlap
+	gives the normal and the depth: the normal points towards this craft,
+	and the contact point is the deepest corner of the other box, or the
+	middle of its edge if that edge lies along the face, moved half the
+	depth towards the face. This box is shrunk by 1% so that crafts
+	resting side by side don't touch.
+*/
 bool Craft::checkCollision(const Craft &other, Vector2 &point, Vector2 &normal)
 {
-	Vector2 myV[4];	// my vertices
-	Vector2 otV[4]; // other's vertices
-	int i;
-	
-	for(i = 0; i < 4; i++)
+	const Vector2 d = other.boxCenter - boxCenter;
+	const float r = 1.99 * RADIUS;
+	if(d * d > r * r) return false;
+
+	// half extents
+	const float ax = 0.99 * 0.5 * WIDTH, ay = 0.99 * 0.5 * HEIGHT;
+	const float bx = 0.5 * WIDTH, by = 0.5 * HEIGHT;
+
+	// box axes, local x and y
+	const Vector2 axes[4] = {
+		boxAxis, boxAxis.normalVector(),
+		other.boxAxis, other.boxAxis.normalVector()};
+
+	// the projections of one box's axes on the other's
+	const float c = fabs(axes[0] * axes[2]);
+	const float s = fabs(axes[0] * axes[3]);
+
+	float dist[4], overlap[4];
+	for(int k = 0; k < 4; k++) dist[k] = d * axes[k];
+
+	overlap[0] = ax + bx * c + by * s - fabs(dist[0]);
+	overlap[1] = ay + bx * s + by * c - fabs(dist[1]);
+	overlap[2] = bx + ax * c + ay * s - fabs(dist[2]);
+	overlap[3] = by + ax * s + ay * c - fabs(dist[3]);
+
+	int axis = 0;
+	for(int k = 0; k < 4; k++)
 	{
-		myV[i] = 0.99 * getVertex(i);
-		myV[i].rotate(getAngle() + getDAngle());
-		myV[i] = myV[i] + getPos() + getDPos();
-		
-		otV[i] = other.getVertex(i);
-		otV[i].rotate(other.getAngle() + other.getDAngle());
-		otV[i] = otV[i] + other.getPos() + other.getDPos();
+		if(overlap[k] <= 0.0) return false;
+		if(overlap[k] < overlap[axis]) axis = k;
 	}
-	
-	Vector2 points[2];
-	int num = 0;
-	for(i = 0; i < 4; i++)
-	{
-		for(int j = 0; j < 4; j++)
-		{
-			// check for contact
-			if(!Level::segmentIsect(myV[i], myV[(i+1)%4], otV[j], otV[(j+1)%4], points[num])) continue;
-			
-			num++;
-			if(num < 2) continue;	// we need 2 contact points
-
-			// collision has occured
-			
-			// contact point
-			point = 0.5 * (points[0] + points[1]);
-			
-			// normal vector
-			normal = (points[1] - points[0]).normalVector();
-			normal.normalize();
-			
-			// check if normal is facing away from this object
-			if((point-getPos()).unitVector() * normal > 0.0)
-			{
-				// it is, flip it!
-				normal = -normal;
-			}
 
-			return true;
-		}
-	}
-	
-	return false;
+	const float depth = overlap[axis];
+	normal = dist[axis] > 0.0 ? -axes[axis] : axes[axis];
+
+	// the face is on this box, the corner on the other one, or the other
+	// way around
+	const Craft &inc = axis < 2 ? other : *this;
+	const Vector2 dir = axis < 2 ? normal : -normal;
+	const Vector2 u = axes[axis < 2 ? 2 : 0], v = axes[axis < 2 ? 3 : 1];
+	const float hx = axis < 2 ? bx : ax, hy = axis < 2 ? by : ay;
+
+	const float du = u * dir, dv = v * dir;
+	point = inc.boxCenter;
+	if(fabs(du) > PARALLEL) point = point + (du > 0.0 ? hx : -hx) * u;
+	if(fabs(dv) > PARALLEL) point = point + (dv > 0.0 ? hy : -hy) * v;
+	point = point - (0.5 * depth) * dir;
+
+	return true;
 }
+
 void Craft::addImpulse(const Vector2 &impulse, const Vector2 &point)
 {
 	// Limit impulses to 5.0 units
@@ -347,6 +488,8 @@ void Craft::addImpulse(const Vector2 &impulse, const Vector2 &point)
 	// reset delta
 	delta.setPos(Vector2(0.0, 0.0));
 	delta.setAngle(0.0);
+	
+	batchSync = BATCH_STALE;
 }
 
 void Craft::handleCollision(Craft &other, const Vector2& point, const Vector2& normal)
@@ -393,6 +536,10 @@ void Craft::handleCollision(Craft &other, const Vector2& point, const Vector2& n
 		if(other.getOmega() > 0.0) other.setAngle(other.getAngle() + 0.05);
 		else  other.setAngle(other.getAngle() - 0.05);
 	}
+	
+	// the crafts have moved and their deltas were reset
+	updateBox();
+	other.updateBox();
 }
 
 Vector2 Craft::getImpulse(Craft &other, float e, const Vector2 &v, const Vector2 &point, const Vector2 &normal)
@@ -415,23 +562,20 @@ Vector2 Craft::getImpulse(Craft &other, float e, const Vector2 &v, const Vector2
 bool Craft::levelCollide()
 {
 	Vector2 point, normal, delta;
-	if(!checkLevelCollision(point, normal, delta)) return false;
+	if(!checkLevelCollision(point, normal, delta))
+	{
+		// The end pose is clear, but a fast craft may have passed
+		// through the track. Stop it where it first touched instead.
+		if(getDPos().length() < minorAxis) return false;
+		
+		float t;
+		if(!world->getLevel().ellipseSweep(getPos(), getPos() + getDPos(), getAngle() + getDAngle(), majorAxis, minorAxis, t, point, normal)) return false;
+		
+		this->delta.setPos(t * getDPos());
+	}
 	
 	setPos(getPos() - 1.1 * delta);
 	
-	
-	glBegin(GL_POINTS);
-	glVertex2fv(point.getData());
-	glEnd();
-	
-	glColor3f(1,0,0);
-	glBegin(GL_LINES);
-	glVertex2fv(point.getData());
-	glVertex2fv((point + normal).getData());
-	glEnd();
-	glColor3f(1,1,1);
-	
-	
 	Vector2 px = point - (getPos() + getDPos());
 	Vector2 v = getVel() + px.rotate(getOmega());
 	
@@ -450,20 +594,15 @@ bool Craft::levelCollide()
 
 bool Craft::checkLevelCollision(Vector2 &point, Vector2 &normal, Vector2 &delta)
 {
-	Level &level = Game::getInstance().getLevel();
+	Level &level = world->getLevel();
 	
 	return level.ellipseIntersect((getPos() + getDPos()), (getAngle() + getDAngle()), majorAxis, minorAxis, point, normal, delta);
 }
 
-int Craft::init()
-{
-	return mesh.loadFromXML("racer.xml");
-}
-
-void Craft::setPos(const Vector2 &p) { state.setPos(p); }
-void Craft::setVel(const Vector2 &v) { dState.setPos(v); }
-void Craft::setAngle(float a) { state.setAngle(a); }
-void Craft::setOmega(float a) { dState.setAngle(a); }
+void Craft::setPos(const Vector2 &p) { state.setPos(p); batchSync = BATCH_STALE; }
+void Craft::setVel(const Vector2 &v) { dState.setPos(v); batchSync = BATCH_STALE; }
+void Craft::setAngle(float a) { state.setAngle(a); batchSync = BATCH_STALE; }
+void Craft::setOmega(float a) { dState.setAngle(a); batchSync = BATCH_STALE; }
 
 float Craft::getX() const { return state.getX(); }
 float Craft::getY() const { return state.getY(); }
@@ -481,14 +620,32 @@ float Craft::getAngle() const { return state.getAngle(); }
 float Craft::getOmega() const { return dState.getAngle(); }
 float Craft::getDAngle() const { return delta.getAngle(); }
 
+// Pose between the previous and the current simulation tick, alpha in [0,1]
+Vector2 Craft::getDrawPos(float alpha) const
+{
+	return prevState.getPos() + alpha * (state.getPos() - prevState.getPos());
+}
+
+float Craft::getDrawAngle(float alpha) const
+{
+	float d = state.getAngle() - prevState.getAngle();
+	
+	// take the short way around when the angle has wrapped
+	if(d > M_PI) d -= 2.0 * M_PI;
+	else if(d < -M_PI) d += 2.0 * M_PI;
+	
+	return prevState.getAngle() + alpha * d;
+}
+
 const Vector2 &Craft::getVertex(int n) const { return vertices[n]; }
 
 float Craft::getBoostFuel() const { return boostFuel; }
 
 float Craft::getHoverForce() const { return hoverForce; }
-float Craft::getSpeed() const { return dState.getPos().length(); }
 
-m3dMesh &Craft::getMesh() const { return mesh; }
+/// Number of force evaluations made so far, for comparing integrators
+int Craft::getDerives() const { return derives; }
+float Craft::getSpeed() const { return dState.getPos().length(); }
 
 bool Craft::beamIntersect(const Vector2& v1, const Vector2& v2, Vector2 &point) const
 {
@@ -505,10 +662,19 @@ bool Craft::beamIntersect(const Vector2& v1, const Vector2& v2, Vector2 &point)
 	return false;
 }
 
-void Craft::addForce(Vector2 &f)
+void Craft::addForce(const Vector2 &f)
 {
 	force = force + f;
 }
 
+void Craft::clearForce()
+{
+	force = Vector2(0.0, 0.0);
+}
+
+/// Active craft pushed by the beam in the last step, or -1
+int Craft::getPushTarget() const { return pushTarget; }
+const Vector2 &Craft::getPush() const { return push; }
+
 
 
@@ -1,28 +1,87 @@
 #ifndef _CRAFT_H_
 #define _CRAFT_H_
 
+class World;
+class m3dMesh;
+
+/// Position and angle of a craft, or their derivatives
+/**
+	The arithmetic is inline so that the integrator runs without calls.
+	The in-place operations let it build each stage without temporaries.
+*/
 class CraftState
 {
 public:
-	CraftState();
-	CraftState(const Vector2& pos, float angle);
+	CraftState() : pos(0.0, 0.0), angle(0.0) { }
+	CraftState(const Vector2& p, float a) : pos(p), angle(a) { }
 	
-	const Vector2& getPos() const;
-	float getAngle() const;
+	const Vector2& getPos() const { return pos; }
+	float getAngle() const { return angle; }
 	
-	float getX() const;
-	float getY() const;
+	float getX() const { return pos.getX(); }
+	float getY() const { return pos.getY(); }
 	
-	void setPos(const Vector2 &p);
-	void setAngle(float a);
+	void setPos(const Vector2 &p) { pos = p; }
+	void setAngle(float a) { angle = a; }
+	
+	CraftState &operator+=(const CraftState &s);
+	CraftState &operator*=(float f);
+	CraftState &addScaled(float f, const CraftState &s);
+	CraftState &setSum(const CraftState &a, float f, const CraftState &b);
 	
 private:
 	Vector2 pos;
 	float angle;
 };
 
-extern CraftState operator+(const CraftState& s1, const CraftState& s2);
-extern CraftState operator*(float f, const CraftState& s2);
+inline CraftState operator+(const CraftState& s1, const CraftState& s2)
+{
+	return CraftState(s1.getPos() + s2.getPos(), s1.getAngle() + s2.getAngle());
+}
+
+inline CraftState operator*(float f, const CraftState& s2)
+{
+	return CraftState(f * s2.getPos(), f * s2.getAngle());
+}
+
+inline CraftState &CraftState::operator+=(const CraftState &s)
+{
+	pos = pos + s.pos;
+	angle += s.angle;
+	return *this;
+}
+
+inline CraftState &CraftState::operator*=(float f)
+{
+	pos = f * pos;
+	angle *= f;
+	return *this;
+}
+
+/// this += f * s
+inline CraftState &CraftState::addScaled(float f, const CraftState &s)
+{
+	pos = pos + f * s.pos;
+	angle += f * s.angle;
+	return *this;
+}
+
+/// this = a + f * b
+inline CraftState &CraftState::setSum(const CraftState &a, float f, const CraftState &b)
+{
+	pos = a.pos + f * b.pos;
+	angle = a.angle + f * b.angle;
+	return *this;
+}
+
+/// Where a hover beam ends and what it pushes
+struct HoverBeam
+{
+	Vector2 start, end;
+	float force;		// along the beam
+	int target;		// active craft the beam hits, or -1
+	Vector2 push;		// force on the target
+};
 
 class Craft
 {
@@ -45,6 +104,7 @@ public:
 	static const float MINOR_AXIS;
 	static const float WIDTH;
 	static const float HEIGHT;
+	static const float RADIUS;
 	static const float INERTIA;
 	static const float MASS;
 	
@@ -58,8 +118,16 @@ public:
 
 	Craft();
 
+	void setWorld(World *w);
+
 	void update(float dt);
+	void updateAdaptive(float dt, float tolerance);
+	void prepare(float dt);
+	void integrate(float dt);
+	void integrateAdaptive(float dt, float tolerance);
+	void saveState();
 	void setControl(int control, bool value);
+	bool getControl(int control) const;
 	
 	void setPos(const Vector2 &p);
 	void setVel(const Vector2 &v);
@@ -80,53 +148,85 @@ public:
 	float getOmega() const;
 	float getDAngle() const;
 	
+	Vector2 getDrawPos(float alpha) const;
+	float getDrawAngle(float alpha) const;
+	
 	bool beamIntersect(const Vector2& v1, const Vector2& v2, Vector2 &point) const;
-	void addForce(Vector2 &f);
+	void addForce(const Vector2 &f);
+	void clearForce();
+	int getPushTarget() const;
+	const Vector2 &getPush() const;
 	
 	float getBoostFuel() const;
 	float getHoverForce() const;
+	int getDerives() const;
 	float getSpeed() const;
 	
 	const Vector2 &getVertex(int n) const;
 	
+	void updateBox();
 	bool collide(Craft &other);
+	bool checkCollision(const Craft &other, Vector2 &point, Vector2 &normal);
 	bool levelCollide();
 	void move();
 
 	void draw2d();
-	void draw3d();
+	void draw3d(float alpha = 1.0);
 	
 	static int init();
 	
 	m3dMesh &getMesh() const;
 
 private:
+	friend class CraftBatch;
+	
+	/// Largest projection of a box axis on the contact normal for an edge contact
+	static const float PARALLEL;
+	
 	CraftState state, dState, delta;
+	CraftState prevState;
+	
+	/// How state and dState stand to the planes of the CraftBatch
+	enum BatchSync {BATCH_STALE, BATCH_INTEGRATED, BATCH_MOVED};
+	BatchSync batchSync;
 	Vector2 vertices[4];
+	
+	/// Collision box of this tick, the center and the direction of the x axis
+	Vector2 boxCenter, boxAxis;
 	float majorAxis, minorAxis;
 	
 	Vector2 beam[2];
 	
+	/// Force from other crafts' beams, constant over a step
 	Vector2 force;
+	
+	/// Force of this craft's beam on another one
+	int pushTarget;
+	Vector2 push;
 
 	bool ctrl[NUM_CONTROLS];
 	
 	Vector2 getImpulse(Craft &other, float e, const Vector2 &v, const Vector2 &point, const Vector2 &normal);
-	bool checkCollision(const Craft &other, Vector2 &point, Vector2 &normal);
 	void handleCollision(Craft &other, const Vector2& point, const Vector2& normal);
 	void addImpulse(const Vector2 &impulse, const Vector2 &point);
 	
 	bool checkLevelCollision(Vector2 &point, Vector2 &normal, Vector2 &delta);
 	
-	template <class T> void integrateRKN(float x0, T y0, T dy0, float dx, T *y, T *dy);
-	CraftState derive(float t, const CraftState &s, const CraftState &ds);
+	template <class T> void integrateRKN(float x0, const T &y0, const T &dy0, float dx, T *y, T *dy);
+	CraftState derive(float t, const CraftState &s, const CraftState &ds, HoverBeam *hover = NULL) const;
+	void setBeam(const HoverBeam &hover);
 	
-	static m3dMesh mesh;
+	static const int MAX_ADAPTIVE_STEPS = 64;
+	
+	World *world;
 	
 	float boostFuel;
 	float hoverForce;
 	float ringTimer;
 	float color[3];
+	
+	float adaptiveStep;
+	int derives;
 };
 
 
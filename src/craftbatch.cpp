@@ -0,0 +1,192 @@
+#include <cmath>
+
+#include "sim.h"
+#include "simd.h"
+
+CraftBatch::CraftBatch()
+{
+	stride = 0;
+	crafts = NULL;
+	numCrafts = 0;
+	stage = 0;
+	pool = NULL;
+}
+
+float *CraftBatch::plane(int p, int c)
+{
+	return &data[(p * 3 + c) * stride];
+}
+
+// out = a over all three components
+void CraftBatch::copy(int out, int a)
+{
+	float *o = plane(out);
+	const float *pa = plane(a);
+	
+	for(int i = 0; i < 3 * stride; i += SIMD_WIDTH) simdStore(o + i, simdLoad(pa + i));
+}
+
+// out = a + b over all three components
+void CraftBatch::add(int out, int a, int b)
+{
+	float *o = plane(out);
+	const float *pa = plane(a);
+	const float *pb = plane(b);
+	
+	for(int i = 0; i < 3 * stride; i += SIMD_WIDTH) simdStore(o + i, simdAdd(simdLoad(pa + i), simdLoad(pb + i)));
+}
+
+// p = s * p over all three components
+void CraftBatch::scale(int p, float s)
+{
+	float *o = plane(p);
+	simd_t vs = simdSet(s);
+	
+	for(int i = 0; i < 3 * stride; i += SIMD_WIDTH) simdStore(o + i, simdMul(vs, simdLoad(o + i)));
+}
+
+// out = sa * a + sb * b over all three components
+void CraftBatch::combine(int out, int a, float sa, int b, float sb)
+{
+	float *o = plane(out);
+	const float *pa = plane(a);
+	const float *pb = plane(b);
+	simd_t va = simdSet(sa), vb = simdSet(sb);
+	
+	for(int i = 0; i < 3 * stride; i += SIMD_WIDTH)
+	{
+		simdStore(o + i, simdAdd(simdMul(va, simdLoad(pa + i)), simdMul(vb, simdLoad(pb + i))));
+	}
+}
+
+// Evaluate accelerations for the stage state SP, SV into plane k
+void CraftBatch::derive(int k)
+{
+	if(pool == NULL || numCrafts <= CHUNK)
+	{
+		derive(k, 0, numCrafts);
+		return;
+	}
+	
+	stage = k;
+	pool->run((numCrafts + CHUNK - 1) / CHUNK, deriveJob, this);
+}
+
+void CraftBatch::deriveJob(int chunk, void *arg)
+{
+	CraftBatch *batch = (CraftBatch *)arg;
+	batch->derive(batch->stage, chunk * CHUNK, MIN((chunk + 1) * CHUNK, batch->numCrafts));
+}
+
+// Evaluate crafts [first, last), the first stage also casts their beams
+void CraftBatch::derive(int k, int first, int last)
+{
+	const float *px = plane(SP, 0), *py = plane(SP, 1), *pa = plane(SP, 2);
+	const float *vx = plane(SV, 0), *vy = plane(SV, 1), *va = plane(SV, 2);
+	float *kx = plane(k, 0), *ky = plane(k, 1), *ka = plane(k, 2);
+	
+	for(int i = first; i < last; i++)
+	{
+		CraftState s(Vector2(px[i], py[i]), pa[i]);
+		CraftState ds(Vector2(vx[i], vy[i]), va[i]);
+		HoverBeam hover;
+		CraftState r = crafts[i]->derive(0.0, s, ds, k == K1 ? &hover : NULL);
+		if(k == K1) crafts[i]->setBeam(hover);
+		crafts[i]->derives++;
+		
+		kx[i] = r.getX();
+		ky[i] = r.getY();
+		ka[i] = r.getAngle();
+	}
+}
+
+/// Integrate a set of crafts over one time step
+/**
+	Equivalent to calling integrateRKN for each craft, the resulting
+	position delta and new velocity are stored back into the crafts.
+	Craft::prepare must have been called for each craft before.
+*/
+void CraftBatch::integrate(Craft **c, int n, float dt, WorkerPool *p)
+{
+	if(n <= 0) return;
+	
+	crafts = c;
+	numCrafts = n;
+	pool = p;
+	
+	if(simdRound(n) > stride)
+	{
+		stride = simdRound(n);
+		data.assign(NUM_PLANES * 3 * stride, 0.0);
+		owners.assign(stride, NULL);
+	}
+	
+	// move the crafts as Craft::move did, then load the ones that were
+	// changed in other ways
+	add(Y0, Y0, DELTA);
+	copy(V0, SV);
+	
+	float *y0x = plane(Y0, 0), *y0y = plane(Y0, 1), *y0a = plane(Y0, 2);
+	float *v0x = plane(V0, 0), *v0y = plane(V0, 1), *v0a = plane(V0, 2);
+	for(int i = 0; i < n; i++)
+	{
+		if(owners[i] == crafts[i] && crafts[i]->batchSync == Craft::BATCH_MOVED) continue;
+		
+		owners[i] = crafts[i];
+		y0x[i] = crafts[i]->getX();
+		y0y[i] = crafts[i]->getY();
+		y0a[i] = crafts[i]->getAngle();
+		v0x[i] = crafts[i]->getVX();
+		v0y[i] = crafts[i]->getVY();
+		v0a[i] = crafts[i]->getOmega();
+	}
+	
+	const float h = dt, h2 = 0.5 * dt;
+	
+	// k1 = h/2 f(y0, v0)
+	copy(SP, Y0);
+	copy(SV, V0);
+	derive(K1);
+	scale(K1, h2);
+	
+	// k2 = h/2 f(y0 + h/2 (v0 + k1/2), v0 + k1)
+	combine(SP, V0, 1.0, K1, 0.5);
+	combine(SP, Y0, 1.0, SP, h2);
+	add(SV, V0, K1);
+	derive(K2);
+	scale(K2, h2);
+	
+	// k3 = h/2 f(y0 + h/2 (v0 + k1/2), v0 + k2)
+	add(SV, V0, K2);
+	derive(K3);
+	scale(K3, h2);
+	
+	// k4 = h/2 f(y0 + h (v0 + k3), v0 + 2 k3)
+	add(SP, V0, K3);
+	combine(SP, Y0, 1.0, SP, h);
+	combine(SV, V0, 1.0, K3, 2.0);
+	derive(K4);
+	scale(K4, h2);
+	
+	// delta = h (v0 + (k1 + k2 + k3) / 3)
+	add(DELTA, K1, K2);
+	add(DELTA, DELTA, K3);
+	combine(DELTA, V0, h, DELTA, h / 3.0);
+	
+	// v = v0 + (k1 + 2 k2 + 2 k3 + k4) / 3
+	add(SV, K2, K3);
+	combine(SV, K1, 1.0, SV, 2.0);
+	add(SV, SV, K4);
+	combine(SV, V0, 1.0, SV, 1.0 / 3.0);
+	
+	// scatter
+	const float *dx = plane(DELTA, 0), *dy = plane(DELTA, 1), *da = plane(DELTA, 2);
+	const float *vx = plane(SV, 0), *vy = plane(SV, 1), *va = plane(SV, 2);
+	for(int i = 0; i < n; i++)
+	{
+		crafts[i]->delta = CraftState(Vector2(dx[i], dy[i]), da[i]);
+		crafts[i]->dState = CraftState(Vector2(vx[i], vy[i]), va[i]);
+		crafts[i]->batchSync = Craft::BATCH_INTEGRATED;
+	}
+}
+
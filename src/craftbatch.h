@@ -0,0 +1,58 @@
+#ifndef _CRAFTBATCH_H_
+#define _CRAFTBATCH_H_
+
+#include <vector>
+
+class WorkerPool;
+
+/// Runge-Kutta-Nyström integration of many crafts at once
+/**
+	CraftBatch performs the same integration step as Craft::update for a
+	whole set of crafts. Positions, angles and their derivatives are
+	gathered into structure-of-arrays planes, so that the stage
+	arithmetic runs SIMD_WIDTH crafts at a time. Only the force
+	evaluation (Craft::derive) is done one craft at a time, spread over
+	a WorkerPool in chunks of CHUNK crafts when one is given.
+	
+	The planes are kept from one step to the next. A craft that was only
+	moved since the last step continues from them, only crafts that were
+	changed otherwise (collisions, resets, other integrators) are loaded
+	again. The results are still written back to every craft.
+*/
+class CraftBatch
+{
+public:
+	CraftBatch();
+	
+	void integrate(Craft **crafts, int n, float dt, WorkerPool *pool = NULL);
+	
+	static const int CHUNK = 16;
+	
+private:
+	// planes of three components (x, y, angle), each stride floats long
+	enum {Y0, V0, SP, SV, K1, K2, K3, K4, DELTA, NUM_PLANES};
+	
+	float *plane(int p, int c = 0);
+	void copy(int out, int a);
+	void add(int out, int a, int b);
+	void scale(int p, float s);
+	void combine(int out, int a, float sa, int b, float sb);
+	void derive(int k);
+	void derive(int k, int first, int last);
+	static void deriveJob(int chunk, void *arg);
+	
+	std::vector<float> data;
+	int stride;
+	
+	// the craft each lane of the planes belongs to
+	std::vector<Craft *> owners;
+	
+	// the crafts being integrated
+	Craft **crafts;
+	int numCrafts;
+	int stage;
+	WorkerPool *pool;
+};
+
+#endif
+
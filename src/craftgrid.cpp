@@ -0,0 +1,68 @@
+#include <cmath>
+
+#include "sim.h"
+
+const float CraftGrid::CELL_SIZE = 1.0;
+
+CraftGrid::CraftGrid()
+{
+	numCells = 0;
+}
+
+// Cell under x, positions off the track go to the first or last cell
+int CraftGrid::cellAt(float x) const
+{
+	int c = (int)floor(x / CELL_SIZE);
+	if(c < 0) return 0;
+	if(c >= numCells) return numCells - 1;
+	return c;
+}
+
+/// Sort n crafts into cells over a track of the given width
+void CraftGrid::build(Craft **crafts, int n, float width)
+{
+	numCells = (int)ceil(width / CELL_SIZE);
+	if(numCells < 1) numCells = 1;
+	
+	cellStart.assign(numCells + 1, 0);
+	cells.resize(n);
+	items.resize(n);
+	
+	// count crafts per cell, then turn the counts into offsets
+	for(int i = 0; i < n; i++)
+	{
+		cells[i] = cellAt(crafts[i]->getPos().getX());
+		cellStart[cells[i] + 1]++;
+	}
+	
+	for(int c = 0; c < numCells; c++) cellStart[c + 1] += cellStart[c];
+	
+	// replace each craft's cell with its slot in the item array
+	for(int i = 0; i < n; i++)
+	{
+		cells[i] = cellStart[cells[i]]++;
+	}
+	
+	// filling advanced every offset by one cell, shift them back
+	for(int c = numCells; c > 0; c--) cellStart[c] = cellStart[c - 1];
+	cellStart[0] = 0;
+	
+	for(int i = 0; i < n; i++) items[cells[i]] = i;
+}
+
+/// Get the items of crafts whose centre may lie within [minX, maxX]
+/**
+	The crafts are getItem(begin) ... getItem(end - 1).
+*/
+void CraftGrid::query(float minX, float maxX, int &begin, int &end) const
+{
+	if(numCells == 0)
+	{
+		begin = end = 0;
+		return;
+	}
+	
+	begin = cellStart[cellAt(minX)];
+	end = cellStart[cellAt(maxX) + 1];
+}
+
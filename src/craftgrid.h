@@ -0,0 +1,36 @@
+#ifndef _CRAFTGRID_H_
+#define _CRAFTGRID_H_
+
+#include <vector>
+
+/// Uniform grid of crafts along the track
+/**
+	Rebuilt every tick from the positions of the active crafts. Each craft
+	is stored in the cell under its centre, and the cells are packed one
+	after another (compressed sparse row layout), so the crafts under any
+	x range are one contiguous run of the item array.
+*/
+class CraftGrid
+{
+public:
+	static const float CELL_SIZE;
+	
+	CraftGrid();
+	
+	void build(Craft **crafts, int n, float width);
+	void query(float minX, float maxX, int &begin, int &end) const;
+	
+	/// Active craft index of the i:th item
+	int getItem(int i) const { return items[i]; }
+	
+private:
+	int cellAt(float x) const;
+	
+	int numCells;
+	std::vector<int> cellStart;
+	std::vector<int> cells;
+	std::vector<int> items;
+};
+
+#endif
+
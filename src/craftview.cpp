@@ -0,0 +1,82 @@
+#include "SDL_opengl.h"
+#include <cmath>
+
+#include <AL/al.h>
+
+#include "antigrav.h"
+
+/*
+	Drawing of crafts. Kept apart from craft.cpp so that the physics
+	can be linked without OpenGL.
+*/
+
+static m3dMesh mesh;
+
+int Craft::init()
+{
+	return mesh.loadFromXML("racer.xml");
+}
+
+m3dMesh &Craft::getMesh() const { return mesh; }
+
+void Craft::draw3d(float alpha)
+{
+	Vector2 pos = getDrawPos(alpha);
+	
+	glPushMatrix();
+	
+	glTranslatef(pos.getX(), pos.getY(), 0.0);
+	glRotatef(DEG(getDrawAngle(alpha)), 0.0, 0.0, 1.0);
+	
+	// draw 3d mesh
+	glEnable(GL_TEXTURE_2D);
+	mesh.draw();
+	glDisable(GL_TEXTURE_2D);
+	
+	glPopMatrix();
+	
+#if 0
+	// draw beam
+	if(state.getAngle() > -M_PI / 2.0 && state.getAngle() < M_PI / 2.0)
+	{
+		glDisable(GL_LIGHTING);
+		glBegin(GL_LINES);
+		glVertex2fv(beam[0].getData());
+		glVertex2fv(beam[1].getData());
+		glEnd();
+		glEnable(GL_LIGHTING);
+	}
+#endif
+}
+
+void Craft::draw2d()
+{
+	glPushMatrix();
+	
+	glTranslatef(state.getPos().getX(), state.getPos().getY(), 0.0);
+	glRotatef(DEG(state.getAngle()), 0.0, 0.0, 1.0);
+	
+	// draw bounding ellipse
+	glBegin(GL_LINE_LOOP);
+	for(int i = 0; i < 16; i++)
+	{
+		glVertex2f(cos((float) i / 16.0 * 2.0 * M_PI) * majorAxis, sin((float) i / 16.0 * 2.0 * M_PI) * minorAxis);
+	}
+	glEnd();
+	
+	// draw bounding box
+	glBegin(GL_LINE_LOOP);
+	for(int i = 0; i < 4; i++)
+	{
+		glVertex2fv(vertices[i].getData());
+	}
+	glEnd();
+	
+	glPopMatrix();
+
+	// draw beam
+	glBegin(GL_LINES);
+	glVertex2fv(beam[0].getData());
+	glVertex2fv(beam[1].getData());
+	glEnd();
+}
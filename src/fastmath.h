@@ -0,0 +1,111 @@
+#ifndef _FASTMATH_H_
+#define _FASTMATH_H_
+
+#include <math.h>
+#include <string.h>
+
+/*
+	Polynomial approximations of the transcendental functions on the
+	physics and culling hot paths. The simulation calls them through the
+	SIM_TAN, SIM_EXP and SIM_ACOS macros, which only pick the fast versions
+	when the package is configured with --enable-fast-math. The error
+	bounds below are measured by bench/fastmathbench against libm.
+*/
+
+#ifdef USE_FAST_MATH
+#define SIM_TAN(x) fastTan(x)
+#define SIM_EXP(x) fastExp(x)
+#define SIM_ACOS(x) fastAcos(x)
+#else
+#define SIM_TAN(x) tan(x)
+#define SIM_EXP(x) exp(x)
+#define SIM_ACOS(x) acosf(x)
+#endif
+
+/// Fast tangent
+/**
+	The argument is reduced to [-pi/4, pi/4] with tan(x) = 1 / tan(pi/2 - x)
+	and evaluated with a Pade approximant. Relative error is below 6e-5
+	for |x| <= pi where |tan(x)| <= 1000, closer to the poles it grows
+	with the rounding of the reduced angle.
+	@param x	the angle in radians
+	@return		tan(x)
+*/
+inline float fastTan(float x)
+{
+	// pi in two parts, so that the reduction stays exact for small k
+	const float piHi = 3.140625f;
+	const float piLo = 9.67653589793e-4f;
+
+	float k = (float)(int)(x * (1.0f / 3.14159265f) + (x < 0.0f ? -0.5f : 0.5f));
+	x = (x - k * piHi) - k * piLo;
+
+	// tan is odd, so work on |x| and restore the sign at the end
+	float a = fabsf(x);
+	bool reciprocal = a > 0.785398163f;
+	if(reciprocal) a = (0.5f * piHi - a) + 0.5f * piLo;
+
+	float a2 = a * a;
+	float p = a * (945.0f + a2 * (-105.0f + a2));
+	float q = 945.0f + a2 * (-420.0f + a2 * 15.0f);
+
+	return copysignf(reciprocal ? q / p : p / q, x);
+}
+
+/// Fast exponential
+/**
+	Splits e^x into 2^n * 2^f with |f| <= 1/2, evaluates 2^f with its
+	Taylor series up to f^5 and builds 2^n in the exponent bits. Relative
+	error is below 7e-6. Arguments are clamped to [-87, 88], so the result
+	stays a normal float.
+	@param x	the exponent
+	@return		e^x
+*/
+inline float fastExp(float x)
+{
+	// adding 1.5 * 2^23 rounds to an integer held in the low mantissa bits
+	const float round = 12582912.0f;
+
+	x = x < -87.0f ? -87.0f : x;
+	x = x > 88.0f ? 88.0f : x;
+
+	float t = x * 1.44269504f;
+	float r = t + round;
+	float f = t - (r - round);
+
+	int n;
+	memcpy(&n, &r, sizeof(n));
+	n -= 0x4b400000;
+
+	float p = 1.0f + f * (0.693147181f + f * (0.240226507f + f * (0.0555041087f
+		+ f * (0.00961812911f + f * 0.00133335581f))));
+
+	int bits = (n + 127) << 23;
+	float scale;
+	memcpy(&scale, &bits, sizeof(scale));
+
+	return p * scale;
+}
+
+/// Fast arc cosine
+/**
+	Abramowitz and Stegun 4.4.45, acos(x) = sqrt(1 - x) * p(x) on [0, 1]
+	and pi - acos(-x) below zero. Absolute error is below 7e-5 radians.
+	Arguments are clamped to [-1, 1], so rounding errors in a normalised
+	dot product give 0 or pi instead of NaN.
+	@param x	the cosine
+	@return		the angle in radians, between 0 and pi
+*/
+inline float fastAcos(float x)
+{
+	bool negative = x < 0.0f;
+	if(negative) x = -x;
+	if(x > 1.0f) x = 1.0f;
+
+	float r = sqrtf(1.0f - x) * (1.5707288f + x * (-0.2121144f + x * (0.0742610f
+		+ x * -0.0187293f)));
+
+	return negative ? 3.14159265f - r : r;
+}
+
+#endif
@@ -14,9 +14,18 @@ const int Game::CONTROLS[MAX_LOCAL_PLAYERS][NUM_CONTROLS] = {
 	{SDLK_l, SDLK_j, SDLK_i},
 	{SDLK_KP6, SDLK_KP4, SDLK_KP8}};
 
+const float Game::SIM_DT = 1.0 / SIM_RATE;
+const float Game::GHOST_ALPHA = 0.35;
+
 const char *Game::PLAYER_TEXTURES[MAX_PLAYERS] = {"", "racer1.png", "racer2.png", "racer3.png", "racer4.png", "racer5.png", "racer6.png", "racer7.png"};
 const float Game::PLAYER_COLORS[MAX_PLAYERS][3] = {{1,0,0},{0,0,1},{0,1,0},{1,1,0}, {0.65, 0, 1}, {0.20, 0.64, 0.69}, {0.89, 0.63, 0.18}, {0.59, 0.56, 0.88}};
 
+// images loaded by init(), decoded in parallel before the loaders ask for them
+static const char *TEXTURES[] = {"racer.png", "road.png", "goal.png", "road2.png", "stone.png",
+	"gauges.png", "needle.png", "fuel.png", "planet.png", "signal.png", "signalred.png", "signalgreen.png",
+	"racer1.png", "racer2.png", "racer3.png", "racer4.png", "racer5.png", "racer6.png", "racer7.png"};
+static const int NUM_TEXTURES = sizeof(TEXTURES) / sizeof(TEXTURES[0]);
+
 GLuint Game::signal;
 GLuint Game::signalred;
 GLuint Game::signalgreen;
@@ -25,14 +34,23 @@ ALuint Game::signalgreenbuffer;
 
 Game::Game()
 {
+	world.setNumPlayers(MAX_PLAYERS);
+	
+	playing = false;
+	recordFile = NULL;
+	races = 0;
+	ghostFile = NULL;
+	ghostPlayer = 0;
+	numBots = 0;
+	
+	simRunning = false;
+	simQuit = false;
+	ticks = 0;
+	snap = NULL;
+	pool = NULL;
+	
 	enable3d = true;
 	enable2d = false;
-	
-	for(int i = 0; i < MAX_PLAYERS; i++)
-	{
-		players[i].setActive(false);
-		players[i].setLocal(false);
-	}
 }
 
 Game::~Game()
@@ -52,6 +70,8 @@ Game::~Game()
 			alDeleteSources(1, &globalSources[i]);
 		}
 	}
+	
+	delete pool;
 }
 
 Game &Game::getInstance()
@@ -59,21 +79,74 @@ Game &Game::getInstance()
 	return instance;
 }
 
-Level &Game::getLevel()
+/// Play a recorded race instead of reading the keyboard
+/**
+	@return 0 on success, -1 if the replay can't be loaded or has more
+	players than the game
+*/
+int Game::setReplay(const char *filename)
 {
-	return level;
+	if(replay.load(filename) != 0) return -1;
+	
+	if(replay.getNumPlayers() > MAX_PLAYERS)
+	{
+		fprintf(stderr, "%s has %d players, at most %d can be shown\n", filename, replay.getNumPlayers(), MAX_PLAYERS);
+		return -1;
+	}
+	
+	if(replay.getDt() != SIM_DT)
+	{
+		fprintf(stderr, "%s was recorded at %.0f ticks per second, the game runs at %d\n", filename, 1.0 / replay.getDt(), SIM_RATE);
+		return -1;
+	}
+	
+	playing = true;
+	return 0;
 }
 
-int Game::init()
+/// Record the controls of race N to PREFIXN.rpl
+void Game::setRecordFile(const char *prefix)
 {
-	// Get viewport
-	glGetIntegerv(GL_VIEWPORT, masterViewport);
-	screenWidth = masterViewport[2];
-	screenHeight = masterViewport[3];
+	recordFile = prefix;
+}
+
+/// Race against the poses in a ghost file
+/**
+	@return 0 on success, -1 if the ghost can't be opened
+*/
+int Game::setGhost(const char *filename)
+{
+	return ghost.open(filename);
+}
+
+/// Save the poses of the first local player of race N to PREFIXN.ghost
+void Game::setGhostRecordFile(const char *prefix)
+{
+	ghostFile = prefix;
+}
+
+/// Race against bots in the slots after the local players
+/**
+	@param n	number of bots, up to MAX_PLAYERS - MAX_LOCAL_PLAYERS
+*/
+void Game::setNumBots(int n)
+{
+	numBots = MAX(0, MIN(n, MAX_PLAYERS - MAX_LOCAL_PLAYERS));
+}
+
+int Game::getNumBots() const { return numBots; }
 
-	// Load resources
+Level &Game::getLevel()
+{
+	return world.getLevel();
+}
+
+// Load the meshes and textures
+int Game::loadGraphics()
+{
 	if(Craft::init() != 0) return 1;
-	if(level.init() != 0) return 1;
+	if(world.init() != 0) return 1;
+	if(world.getLevel().initGraphics() != 0) return 1;
 	if(Font::getInstance().init() != 0) return 1;
 	if(Player::init() != 0) return 1;
 	if(Ring::init() != 0) return 1;
@@ -90,15 +163,8 @@ int Game::init()
 	signalgreen = m3dTexture::loadTexture("signalgreen.png");
 	if(signalgreen==0)
 		return -1;
-
-/*	signalredbuffer = alutCreateBufferWaveform(ALUT_WAVEFORM_SINE, 200.0, 0.0, 0.4);
-	signalgreenbuffer = alutCreateBufferWaveform(ALUT_WAVEFORM_SINE, 300.0, 0.0, 0.7);*/
-	signalredbuffer = loadWavBuffer("signalred.wav");
-	if(signalredbuffer == AL_NONE) return -1;
-	signalgreenbuffer = loadWavBuffer("signalgreen.wav");
-	if(signalgreenbuffer == AL_NONE) return -1;
 	
-	playerTex[0] = players[0].getCraft().getMesh().getTexture(0);
+	playerTex[0] = getPlayer(0).getCraft().getMesh().getTexture(0);
 	for(int i = 1; i < MAX_PLAYERS; i++)
 	{
 		if(playerTex[i].load(PLAYER_TEXTURES[i]) != 0)
@@ -107,10 +173,37 @@ int Game::init()
 		}
 	}
 	
+	return 0;
+}
+
+int Game::init()
+{
+	// Get viewport
+	glGetIntegerv(GL_VIEWPORT, masterViewport);
+	screenWidth = masterViewport[2];
+	screenHeight = masterViewport[3];
+
+	// Start the job system, level generation runs on it too
+	pool = new WorkerPool();
+	world.setWorkerPool(pool);
+	
+	// Load resources, images that weren't asked for are dropped
+	m3dTexture::preload(NUM_TEXTURES, TEXTURES, pool);
+	int result = loadGraphics();
+	m3dTexture::freePreloaded();
+	if(result != 0) return result;
+
+/*	signalredbuffer = alutCreateBufferWaveform(ALUT_WAVEFORM_SINE, 200.0, 0.0, 0.4);
+	signalgreenbuffer = alutCreateBufferWaveform(ALUT_WAVEFORM_SINE, 300.0, 0.0, 0.7);*/
+	signalredbuffer = loadWavBuffer("signalred.wav");
+	if(signalredbuffer == AL_NONE) return -1;
+	signalgreenbuffer = loadWavBuffer("signalgreen.wav");
+	if(signalgreenbuffer == AL_NONE) return -1;
+	
 	for(int i = 0; i < MAX_PLAYERS; i++)
 	{
-		players[i].setTexture(&playerTex[i]);
-		players[i].setColor(PLAYER_COLORS[i]);
+		getPlayer(i).setTexture(&playerTex[i]);
+		getPlayer(i).setColor(PLAYER_COLORS[i]);
 	}
 
 	// set up player sources
@@ -123,7 +216,7 @@ int Game::init()
 
 	for(int i = 0; i < MAX_PLAYERS; i++)
 	{
-		players[i].setSource(playerSources[i]);
+		getPlayer(i).setSource(playerSources[i]);
 	}
 	
 	// set up global sources
@@ -169,40 +262,73 @@ int Game::gameLoop()
 	float t;
 	bool loop;
 	
-	// <temporary>
-	// generate level
-	level.generate(time(NULL));
-	// </temporary>
+	if(playing)
+	{
+		// the replay brings its own level and players
+		replay.setup(world);
+		
+		// watch the first craft when nobody was at the keyboard
+		bool local = false;
+		for(int i = 0; i < MAX_PLAYERS; i++) local |= getPlayer(i).isActive() && getPlayer(i).isLocal();
+		for(int i = 0; i < MAX_PLAYERS && !local; i++)
+		{
+			if(getPlayer(i).isActive()) getPlayer(i).setLocal(local = true);
+		}
+	} else
+	{
+		// <temporary>
+		// generate level
+		world.generate(time(NULL));
+		// </temporary>
+	}
+	world.getLevel().createLists();
+	
+	// the bots vary with the level, so each race is driven the same way
+	// when it is replayed
+	for(int i = 0; i < MAX_PLAYERS; i++)
+	{
+		bots[i].reset(*Bot::findProfile("boost"), world.getSeed(), i);
+	}
 
 	backg = Background();
 
 	// set up starting grid
-	int grid = 0;
-	activeplayers = 0;
+	world.reset();
+	if(recordFile != NULL) recording.start(world, SIM_DT);
+	
+	// the ghost is drawn with, and recorded from, the first local craft
+	ghostPlayer = 0;
+	while(ghostPlayer < MAX_PLAYERS - 1 && !(getPlayer(ghostPlayer).isActive() && getPlayer(ghostPlayer).isLocal())) ghostPlayer++;
+	if(ghostFile != NULL)
+	{
+		char filename[1024];
+		snprintf(filename, sizeof(filename), "%s%d.ghost", ghostFile, races);
+		if(ghostRecording.create(filename, SIM_DT) == 0) ghostRecording.record(getPlayer(ghostPlayer).getCraft());
+	}
+	activeplayers = world.getActivePlayers();
+	
+	// hand the starting grid to the renderer, then leave the world to
+	// the simulation thread until the race is over
+	for(int i = 0; i < MAX_PLAYERS; i++) controls[i] = 0;
+	ticks = 0;
+	publish();
+	simRunning = false;
+	simQuit = false;
+	simThread = std::thread(&Game::simLoop, this);
 	for(int i = 0; i < MAX_PLAYERS; i++)
 	{
 		playerFinishTime[i].plr = -1;
-		if(!players[i].isActive()) continue;
-		++activeplayers;
-		
-		float xPos = 15.0 - grid * 0.75;
-		float yPos = 0.75 + (grid & 1) * 0.5;
-		grid++;
-		
-		players[i].reset(xPos, level.getHeight(xPos) + yPos);
+		if(!getPlayer(i).isActive()) continue;
 
 		playerFinishTime[i].plr = i;
 		playerFinishTime[i].time = -1;
 	}
 
-	// Clear rings
-	Ring::resetAll();
-
 	// set up viewports
 	int temp = 0;
 	for(int i = 0; i < MAX_PLAYERS; i++)
 	{
-		if(players[i].isActive() && players[i].isLocal()) temp++;
+		if(getPlayer(i).isActive() && getPlayer(i).isLocal()) temp++;
 	}
 	
 	initViewports(temp);
@@ -222,12 +348,14 @@ int Game::gameLoop()
 	
 	// set up timer
 	fps = 0.0;
-	int numFrames = 0, skippedFrames = 0;
+	tickRate = 0.0;
+	interp = 1.0;
+	int numFrames = 0, skippedFrames = 0, lastTicks = 0;
 	Uint32 frameTime = 0, fpsTimer = 0;
 	showFps = false;
 	
-	// start main loop
-	state = WAITFORSTART;
+	// start main loop, replays start the countdown right away
+	state = playing ? START : WAITFORSTART;
 	stateTimer = 0;
 	loop = true;
 	startTime = SDL_GetTicks();
@@ -240,12 +368,20 @@ int Game::gameLoop()
 		frameTime = (SDL_GetTicks() - startTime);
 		t = (frameTime) / 1000.0f;
 		
+		// take the latest tick and blend from the one before it, up to a
+		// tick after it was published
+		snap = &snapshots.getFront();
+		interp = std::chrono::duration<float>(std::chrono::steady_clock::now() - snap->stamp).count() / SIM_DT;
+		if(interp > 1.0) interp = 1.0;
+		
 		fpsTimer += frameTime;
 		if(numFrames++ >= 5)
 		{
 			if(fpsTimer == 0) fpsTimer = 1;			// avoid division by zero on smoking fast machines
 			fps = (float)(1000 * (numFrames - skippedFrames)) / fpsTimer;
 			updateRate = (float)(1000 * numFrames) / fpsTimer;
+			tickRate = (float)(1000 * (snap->ticks - lastTicks)) / fpsTimer;
+			lastTicks = snap->ticks;
 			numFrames = 0;
 			fpsTimer = 0;
 			skippedFrames = 0;
@@ -253,6 +389,7 @@ int Game::gameLoop()
 		
 		startTime = SDL_GetTicks();
 
+
 		// Handle events
 		while(SDL_PollEvent(&event))
 		{
@@ -283,39 +420,47 @@ int Game::gameLoop()
 			}
 		}
 
-		stateTimer += t;
-
 		switch(state) {
 			case WAITFORSTART:
+				stateTimer += t;
 				break;
 			case START:
+				stateTimer += t;
 				if(stateTimer > 4.0) {
 					state = GAME;
 					stateTimer = 0;
+					simRunning = true;
 				}
 				break;
 			case GAME: {
+				stateTimer += t;
 				// Check if all players have finished
-				int finp=0;
-				for(int p=0;p<8;p++)
-					if(players[p].isActive() && players[p].isFinished())
-						finp++;
-				if(finp==activeplayers) {
+				if(snap->finishedPlayers==activeplayers) {
 					state = FINISHED;
 					stateTimer = 0;
+					for(int p=0;p<MAX_PLAYERS;p++)
+						if(playerFinishTime[p].plr!=-1)
+							playerFinishTime[p].time =
+								snap->players[p].getFinishTime();
 					qsort(playerFinishTime,MAX_PLAYERS,sizeof(PlayerStat),
 							sortStats);
 				}
-				// Update
-				updateWorld(t);
 				} break;
 
 			case FINISHED:
-				// Update
-				updateWorld(t);
+				stateTimer += t;
 				if(stateTimer>=5.0)
 					loop = false;
 		}
+		
+		// engine sounds follow the latest tick
+		if(state == GAME || state == FINISHED)
+		{
+			for(int i = 0; i < MAX_PLAYERS; i++)
+			{
+				if(snap->players[i].isActive()) snap->players[i].updateSound();
+			}
+		}
 
 		// skip frames to maintain solid frame rate
 		if(frameTime > MAX_FRAME_TIME && FRAMESKIP)
@@ -330,6 +475,9 @@ int Game::gameLoop()
 		updateListener();
 	}
 	
+	simQuit = true;
+	simThread.join();
+	
 	// Kill all audio
 	for(int i = 0; i < MAX_PLAYERS; i++)
 	{
@@ -345,6 +493,15 @@ int Game::gameLoop()
 		if(state == AL_PLAYING) alSourceStop(globalSources[i]);
 	}
 
+	if(recordFile != NULL)
+	{
+		char filename[1024];
+		snprintf(filename, sizeof(filename), "%s%d.rpl", recordFile, races);
+		recording.save(filename);
+	}
+	ghostRecording.close();
+	races++;
+	
 	return state!=FINISHED;
 }
 
@@ -353,7 +510,7 @@ bool Game::updateControls(int keysym, bool down)
 {
 	int pl = -1;
 	int ctrl = -1;
-	if(state!=GAME) return false;
+	if(state!=GAME || playing) return false;
 
 	for(int i = 0; i < MAX_LOCAL_PLAYERS; i++)
 	{
@@ -374,13 +531,12 @@ bool Game::updateControls(int keysym, bool down)
 	
 	for(int i = 0; i < MAX_PLAYERS; i++)
 	{
-		if(!players[i].isLocal()) continue;
+		if(!getPlayer(i).isLocal()) continue;
 		if(pl == 0)
 		{
-			if(!players[i].isFinished())
-				players[i].getCraft().setControl(ctrl, down);
-			else
-				players[i].getCraft().setControl(ctrl,false);
+			// picked up by the simulation thread at the next tick
+			if(down) controls[i] |= 1 << ctrl;
+			else controls[i] &= ~(1 << ctrl);
 			return true;
 		}
 		
@@ -390,45 +546,77 @@ bool Game::updateControls(int keysym, bool down)
 	return false;
 }
 
-void Game::updateWorld(float t)
+// Run the race at a fixed tick until the game loop is done with it.
+// Ticks that fall too far behind are dropped instead of spiralling.
+void Game::simLoop()
 {
-	// update crafts
-	for(int i = 0; i < MAX_PLAYERS; i++)
+	const std::chrono::steady_clock::duration tick =
+		std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(SIM_DT));
+	std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now();
+	
+	while(!simQuit)
 	{
-		if(!players[i].isActive()) continue;
-		if(players[i].update(t)) {
-			// Player finished
-			playerFinishTime[i].time = stateTimer;
+		if(!simRunning)
+		{
+			// waiting for the countdown
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			next = std::chrono::steady_clock::now();
+			continue;
 		}
+		
+		step();
+		publish();
+		
+		next += tick;
+		std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		if(now - next > MAX_SIM_STEPS * tick) next = now;
+		std::this_thread::sleep_until(next);
 	}
+}
 
-	// Update rings
-	Ring::updateAll(t);
-
-	// handle craft to craft collisions
-	for(int i = 0; i < MAX_PLAYERS - 1; i++)
+// Advance the world by one tick
+void Game::step()
+{
+	if(playing)
 	{
-		if(!players[i].isActive()) continue;
-		Craft &craft1 = players[i].getCraft();
-
-		for(int j = i + 1; j < MAX_PLAYERS; j++)
+		replay.play(world);
+	} else
+	{
+		for(int i = 0; i < MAX_PLAYERS; i++)
 		{
-			if(!players[j].isActive()) continue;
-			Craft &craft2 = players[j].getCraft();
-
-			if(!craft1.collide(craft2)) craft2.collide(craft1);
+			Player &player = getPlayer(i);
+			if(!player.isActive()) continue;
+			
+			if(!player.isLocal())
+			{
+				bots[i].drive(player.getCraft(), world.getLevel());
+				continue;
+			}
+			
+			int mask = player.isFinished() ? 0 : controls[i].load();
+			for(int c = 0; c < NUM_CONTROLS; c++) player.getCraft().setControl(c, mask & (1 << c));
 		}
+		
+		if(recordFile != NULL) recording.record(world);
 	}
+	
+	world.update(SIM_DT);
+	ghostRecording.record(getPlayer(ghostPlayer).getCraft());
+	ticks++;
+}
 
-	// handle craft to level collisions and move crafts
-	for(int i = 0; i < MAX_PLAYERS; i++)
-	{
-		if(!players[i].isActive()) continue;
-
-		players[i].getCraft().levelCollide();
-		players[i].getCraft().move();
-	}
-
+// Copy what the renderer needs into a snapshot and hand it over
+void Game::publish()
+{
+	Snapshot &s = snapshots.getBack();
+	for(int i = 0; i < MAX_PLAYERS; i++) s.players[i] = getPlayer(i);
+	s.rings = world.getRings();
+	s.time = world.getTime();
+	s.ticks = ticks;
+	s.finishedPlayers = world.getFinishedPlayers();
+	s.stamp = std::chrono::steady_clock::now();
+	
+	snapshots.publish();
 }
 
 void Game::initViewports(int num)
@@ -478,7 +666,7 @@ void Game::drawFrame()
 	int vp = numViewports - 1;
 	for(int i = MAX_PLAYERS-1; i >= 0; i--)
 	{
-		if(!players[i].isActive() || !players[i].isLocal()) continue;
+		if(!snap->players[i].isActive() || !snap->players[i].isLocal()) continue;
 			
 		drawViewport(i, viewports[vp--]);
 		if(vp < 0) break;
@@ -498,17 +686,47 @@ void Game::draw3d(const float *eye, const float *at, float fovDiag)
 	glEnable(GL_LIGHTING);
 	glEnable(GL_DEPTH_TEST);
 	
-	level.draw3d(eye, at, fovDiag);
+	world.getLevel().draw3d(eye, at, fovDiag);
 	
 	for(int i = 0; i < MAX_PLAYERS; i++)
 	{
-		if(!players[i].isActive()) continue;
+		if(!snap->players[i].isActive()) continue;
 
-		players[i].getCraft().getMesh().setTexture(0, players[i].getTexture());
-		players[i].getCraft().draw3d();
+		snap->players[i].getCraft().getMesh().setTexture(0, snap->players[i].getTexture());
+		snap->players[i].getCraft().draw3d(interp);
 	}
+	
+	if(ghost.isOpen()) drawGhost();
 
-	Ring::drawAll();
+	snap->rings.draw();
+}
+
+// Draw the ghost translucent, at the time of the race the crafts are
+// drawn at. It is blended over the track but hidden by the crafts.
+void Game::drawGhost()
+{
+	Vector2 pos;
+	float angle;
+	if(!ghost.getPose(snap->time - (1.0 - interp) * SIM_DT, pos, angle)) return;
+	
+	m3dMesh &mesh = snap->players[ghostPlayer].getCraft().getMesh();
+	mesh.setTexture(0, snap->players[ghostPlayer].getTexture());
+	
+	glPushMatrix();
+	glTranslatef(pos.getX(), pos.getY(), 0.0);
+	glRotatef(DEG(angle), 0.0, 0.0, 1.0);
+	
+	glEnable(GL_BLEND);
+	glDepthMask(GL_FALSE);
+	
+	glEnable(GL_TEXTURE_2D);
+	mesh.draw(GHOST_ALPHA);
+	glDisable(GL_TEXTURE_2D);
+	
+	glDepthMask(GL_TRUE);
+	glDisable(GL_BLEND);
+	
+	glPopMatrix();
 }
 
 void Game::draw2d()
@@ -516,13 +734,13 @@ void Game::draw2d()
 	glDisable(GL_DEPTH_TEST);
 	glDisable(GL_LIGHTING);
 	
-	level.draw2d();
+	world.getLevel().draw2d();
 	
 	for(int i = 0; i < MAX_PLAYERS; i++)
 	{
-		if(!players[i].isActive()) continue;
+		if(!snap->players[i].isActive()) continue;
 
-		players[i].getCraft().draw2d();
+		snap->players[i].getCraft().draw2d();
 	}
 }
 
@@ -547,12 +765,13 @@ void Game::drawViewport(int current, const GLint *viewport)
 	glMatrixMode(GL_MODELVIEW);
 	glLoadIdentity();
 	
-	Craft &craft = players[current].getCraft();
+	Craft &craft = snap->players[current].getCraft();
+	Level &level = world.getLevel();
 	
 	// Set camera position
 	float eyeX, eyeY, eyeZ;
 	float centerX, centerY, centerZ;
-	eyeX = craft.getX();
+	eyeX = craft.getDrawPos(interp).getX();
 	if(eyeX < 10.0) eyeX = 10.0;
 	if(eyeX > level.getWidth() - 10.0) eyeX = level.getWidth() - 10.0;
 	
@@ -589,7 +808,7 @@ void Game::drawViewport(int current, const GLint *viewport)
 	if(enable3d) draw3d(eye, at, fovDiag);
 	if(enable2d) draw2d();
 	
-	players[current].drawHud(viewport, activeplayers, current);
+	snap->players[current].drawHud(viewport, activeplayers, current);
 }
 
 void Game::drawHud()
@@ -705,8 +924,8 @@ void Game::drawHud()
 	{
 		glPushMatrix();
 		glTranslatef(width - 10.0, 0.0, 0.0);
-		Font::getInstance().printf(" fps: %d\nrate: %d",
-				(int)fps, (int)updateRate);
+		Font::getInstance().printf(" fps: %d\nrate: %d\ntick: %d",
+				(int)fps, (int)updateRate, (int)tickRate);
 		glPopMatrix();
 	}
 	
@@ -722,6 +941,8 @@ void Game::drawRadar(float width, float height, float alpha)
 {
 	(void)height;
 	
+	Level &level = world.getLevel();
+	
 	// draw radar
 	glPushMatrix();
 	glDisable(GL_TEXTURE_2D);
@@ -752,13 +973,14 @@ void Game::drawRadar(float width, float height, float alpha)
 	glBegin(GL_POINTS);
 	for(int i = 0; i < MAX_PLAYERS; i++)
 	{
-		if(!players[i].isActive()) continue;
+		if(!snap->players[i].isActive()) continue;
 		
-		float x = players[i].getCraft().getX();
-		float y = players[i].getCraft().getY();
+		Vector2 pos = snap->players[i].getCraft().getDrawPos(interp);
+		float x = pos.getX();
+		float y = pos.getY();
 		if(x>0 && x<level.getWidth() && y>0 && y<maxHeight) {
-			players[i].bindColor(alpha);
-			glVertex2fv(players[i].getCraft().getPos().getData());
+			snap->players[i].bindColor(alpha);
+			glVertex2fv(pos.getData());
 		}
 	}
 	glEnd();
@@ -839,7 +1061,7 @@ void Game::drawStatistics(float width, float height)
 
 Player &Game::getPlayer(int n)
 {
-	return players[n];
+	return world.getPlayer(n);
 }
 
 void Game::resetListener()
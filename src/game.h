@@ -1,6 +1,10 @@
 #ifndef _GAME_H_
 #define _GAME_H_
 
+#include <atomic>
+#include <chrono>
+#include <thread>
+
 class Craft;
 class Level;
 
@@ -25,6 +29,23 @@ public:
 	static const bool FRAMESKIP = false;
 	static const bool FRAME_LIMITER = false;
 	
+	static const int SIM_RATE = 240;
+	static const int MAX_SIM_STEPS = 24;
+	static const float SIM_DT;
+	
+	static const float GHOST_ALPHA;
+	
+	/// What the renderer needs from one tick of the simulation
+	struct Snapshot
+	{
+		Player players[MAX_PLAYERS];
+		RingList rings;
+		double time;
+		int ticks;
+		int finishedPlayers;
+		std::chrono::steady_clock::time_point stamp;	// when it was published
+	};
+	
 	static const char *PLAYER_TEXTURES[MAX_PLAYERS];
 	static const float PLAYER_COLORS[MAX_PLAYERS][3];
 	static const int CONTROLS[MAX_LOCAL_PLAYERS][NUM_CONTROLS];
@@ -38,6 +59,14 @@ public:
 	
 	void initViewports(int num);
 	
+	int setReplay(const char *filename);
+	void setRecordFile(const char *prefix);
+	int setGhost(const char *filename);
+	void setGhostRecordFile(const char *prefix);
+	
+	void setNumBots(int n);
+	int getNumBots() const;
+	
 	Player &getPlayer(int n);
 	
 	ALuint getSource();
@@ -47,22 +76,55 @@ private:
 	
 	Game();
 	
+	int loadGraphics();
+	
 	void drawFrame();
 	void drawViewport(int current, const GLint *viewport);
 	void draw2d();
 	void draw3d(const float *eye, const float *at, float fovDiag);
+	void drawGhost();
 	void drawHud();
 	void drawRadar(float width, float height, float alpha = 1.0);
 	void drawStatistics(float width, float height);
 	
 	bool updateControls(int keysym, bool down);
-	void updateWorld(float t);
+	void simLoop();
+	void step();
+	void publish();
 	
 	void resetListener();
 	void updateListener();
 	
-	Player players[MAX_PLAYERS];
-	Level level;
+	World world;
+	
+	/// Threads for loading and generation
+	WorkerPool *pool;
+	
+	/// The simulation thread and what it shares with the render thread
+	std::thread simThread;
+	std::atomic<bool> simRunning, simQuit;
+	std::atomic<int> controls[MAX_PLAYERS];
+	TripleBuffer<Snapshot> snapshots;
+	int ticks;
+	
+	/// The snapshot drawn in this frame
+	Snapshot *snap;
+	
+	Replay replay, recording;
+	bool playing;
+	const char *recordFile;
+	
+	/// Races finished, numbers the recordings and ghosts
+	int races;
+	
+	/// Drivers of the active players that aren't local
+	Bot bots[MAX_PLAYERS];
+	int numBots;
+	
+	/// Poses of an earlier race, and of this one when recording
+	Ghost ghost, ghostRecording;
+	const char *ghostFile;
+	int ghostPlayer;
 	
 	m3dTexture playerTex[MAX_PLAYERS];
 	
@@ -75,7 +137,9 @@ private:
 	int screenWidth, screenHeight;
 	
 	bool showFps;
-	float fps, updateRate;
+	float fps, updateRate, tickRate;
+	
+	float interp;
 	
 	ALuint playerSources[MAX_PLAYERS];
 	ALuint globalSources[GLOBAL_SOURCES];
@@ -0,0 +1,201 @@
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+
+#include "sim.h"
+
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+static const char MAGIC[4] = {'A', 'G', 'G', 'H'};
+
+Ghost::Ghost()
+{
+	out = NULL;
+	data = NULL;
+	size = 0;
+	stride = 0;
+	numPoses = 0;
+	dt = 0.0;
+}
+
+Ghost::~Ghost()
+{
+	close();
+}
+
+/// Start recording a ghost
+/**
+	Call this after World::reset() and record() after every tick.
+	@param dt	the length of the ticks
+	@return 0 on success, -1 if the file can't be opened
+*/
+int Ghost::create(const char *filename, float dt)
+{
+	close();
+	
+	out = fopen(filename, "wb");
+	if(out == NULL)
+	{
+		fprintf(stderr, "Can't open %s for writing\n", filename);
+		return -1;
+	}
+	
+	Header header;
+	memcpy(header.magic, MAGIC, sizeof(MAGIC));
+	header.version = FORMAT_VERSION;
+	header.dt = dt;
+	header.stride = sizeof(Pose);
+	fwrite(&header, sizeof(header), 1, out);
+	
+	return 0;
+}
+
+/// Append the pose of a craft
+void Ghost::record(const Craft &craft)
+{
+	if(out == NULL) return;
+	
+	Pose pose = {craft.getX(), craft.getY(), craft.getAngle()};
+	fwrite(&pose, sizeof(pose), 1, out);
+}
+
+/// Open a ghost for playback
+/**
+	@return 0 on success, -1 if the file can't be read or is not a ghost
+*/
+int Ghost::open(const char *filename)
+{
+	close();
+	
+#ifdef HAVE_MMAP
+	int fd = ::open(filename, O_RDONLY);
+	struct stat st;
+	if(fd < 0 || fstat(fd, &st) != 0)
+	{
+		fprintf(stderr, "Can't open %s\n", filename);
+		if(fd >= 0) ::close(fd);
+		return -1;
+	}
+	
+	size = st.st_size;
+	void *map = size >= sizeof(Header) ? mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+	::close(fd);
+	data = map != MAP_FAILED ? (const char *)map : NULL;
+#else
+	FILE *in = fopen(filename, "rb");
+	if(in == NULL)
+	{
+		fprintf(stderr, "Can't open %s\n", filename);
+		return -1;
+	}
+	
+	fseek(in, 0, SEEK_END);
+	size = ftell(in);
+	fseek(in, 0, SEEK_SET);
+	
+	char *buf = size >= sizeof(Header) ? new char[size] : NULL;
+	if(buf != NULL && fread(buf, 1, size, in) != size)
+	{
+		delete [] buf;
+		buf = NULL;
+	}
+	fclose(in);
+	data = buf;
+#endif
+	
+	const Header *header = (const Header *)data;
+	if(data == NULL || memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version != (unsigned int)FORMAT_VERSION ||
+		header->dt <= 0.0 || header->stride < sizeof(Pose) || size < sizeof(Header) + header->stride)
+	{
+		fprintf(stderr, "%s is not a valid ghost\n", filename);
+		close();
+		return -1;
+	}
+	
+	dt = header->dt;
+	stride = header->stride;
+	numPoses = (size - sizeof(Header)) / stride;
+	
+	return 0;
+}
+
+bool Ghost::isOpen() const
+{
+	return data != NULL;
+}
+
+const Ghost::Pose &Ghost::getPose(int n) const
+{
+	return *(const Pose *)(data + sizeof(Header) + n * stride);
+}
+
+/// Pose of the ghost at a time of the race
+/**
+	Interpolates between the two ticks around t. The ghost stays at its
+	first pose before the start and at its last one after it ends.
+	@return false if no ghost is open
+*/
+bool Ghost::getPose(float t, Vector2 &pos, float &angle) const
+{
+	if(data == NULL) return false;
+	
+	float f = t / dt;
+	int n = (int)floor(f);
+	if(n < 0) f = n = 0;
+	if(n >= numPoses - 1) f = n = numPoses - 1;
+	
+	const Pose &p0 = getPose(n), &p1 = getPose(n + 1 < numPoses ? n + 1 : n);
+	float alpha = f - n;
+	
+	// take the short way around when the angle has wrapped
+	float d = p1.angle - p0.angle;
+	if(d > M_PI) d -= 2.0 * M_PI;
+	else if(d < -M_PI) d += 2.0 * M_PI;
+	
+	pos = Vector2(p0.x + alpha * (p1.x - p0.x), p0.y + alpha * (p1.y - p0.y));
+	angle = p0.angle + alpha * d;
+	
+	return true;
+}
+
+int Ghost::getNumPoses() const { return numPoses; }
+float Ghost::getDt() const { return dt; }
+
+/// Finish recording or playback
+/**
+	@return 0 on success, -1 if a recording couldn't be written
+*/
+int Ghost::close()
+{
+	int ret = 0;
+	
+	if(out != NULL)
+	{
+		if(fclose(out) != 0)
+		{
+			fprintf(stderr, "Can't write ghost\n");
+			ret = -1;
+		}
+		out = NULL;
+	}
+	
+	if(data != NULL)
+	{
+#ifdef HAVE_MMAP
+		munmap((void *)data, size);
+#else
+		delete [] data;
+#endif
+		data = NULL;
+	}
+	
+	size = 0;
+	numPoses = 0;
+	
+	return ret;
+}
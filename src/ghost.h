@@ -0,0 +1,63 @@
+#ifndef _GHOST_H_
+#define _GHOST_H_
+
+#include <cstdio>
+
+/// Poses of a craft from an earlier race
+/**
+	A ghost file holds the position and angle of one craft after every
+	tick, at a fixed stride after a short header. The poses are drawn
+	as they are, so a ghost costs nothing to simulate. Files are opened
+	with mmap() where available, so long time trials stay out of the
+	heap and only the pages around the current pose are read in. The
+	values are stored in host byte order.
+*/
+class Ghost
+{
+public:
+	static const int FORMAT_VERSION = 1;
+
+	Ghost();
+	~Ghost();
+
+	int create(const char *filename, float dt);
+	void record(const Craft &craft);
+
+	int open(const char *filename);
+	bool isOpen() const;
+	bool getPose(float t, Vector2 &pos, float &angle) const;
+	int getNumPoses() const;
+	float getDt() const;
+
+	int close();
+
+private:
+	/// Position and angle after a tick
+	struct Pose
+	{
+		float x, y, angle;
+	};
+
+	/// Start of the file, followed by the poses
+	struct Header
+	{
+		char magic[4];
+		unsigned int version;
+		float dt;
+		unsigned int stride;	// bytes from one pose to the next
+	};
+
+	// recording
+	FILE *out;
+
+	// playback
+	const char *data;
+	size_t size;
+	unsigned int stride;
+	int numPoses;
+	float dt;
+
+	const Pose &getPose(int n) const;
+};
+
+#endif
@@ -1,8 +1,6 @@
-#include "SDL_opengl.h"
-#include <AL/al.h>
 #include <cmath>
 
-#include "antigrav.h"
+#include "sim.h"
 
 const float Level::VERTEX_DIST = Terrain::VERTEX_DIST;
 
@@ -14,26 +12,28 @@ Level::Level()
 	{
 		vertices[i] = Vector2(i * VERTEX_DIST, 0.0);
 	}
-}
-
-void Level::draw3d(const float *eye, const float *at, float fovDiag)
-{
-	glPushMatrix();
-	glTranslatef(0.0, 0.0, -(float)ZERO_DEPTH/2.0);
-	terrain.drawLists(eye, at, fovDiag, -(float)ZERO_DEPTH/2.0);
-	
-	glEnable(GL_TEXTURE_2D);
-	terrain.drawRoad(ZERO_DEPTH);
-	glDisable(GL_TEXTURE_2D);
 	
-	glPopMatrix();
+	computeSegments();
 }
 
-void Level::draw2d()
+void Level::computeSegments()
 {
-	glBegin(GL_LINE_STRIP);
-	for(int i = 0; i < MAX_VERTICES; i++) glVertex2fv(vertices[i].getData());
-	glEnd();
+	for(int i = 0; i < MAX_VERTICES - 1; i++)
+	{
+		const Vector2 &a = vertices[i];
+		const Vector2 &b = vertices[i+1];
+		
+		slopes[i] = (b.getY() - a.getY()) / (b.getX() - a.getX());
+		intercepts[i] = a.getY() - slopes[i] * a.getX();
+		
+		lengths[i] = (b - a).length();
+		directions[i] = (1.0 / lengths[i]) * (b - a);
+	}
+	
+	slopes[MAX_VERTICES-1] = 0.0;
+	intercepts[MAX_VERTICES-1] = vertices[MAX_VERTICES-1].getY();
+	lengths[MAX_VERTICES-1] = 0.0;
+	directions[MAX_VERTICES-1] = Vector2(1.0, 0.0);
 }
 
 bool Level::intersect(const Vector2& v1, const Vector2 &v2, Vector2 &point) const
@@ -71,14 +71,99 @@ bool Level::intersect(const Vector2& v1, const Vector2 &v2, Vector2 &point) cons
 	return isect;
 }
 
+/// Find the first point where a ray hits the track
+/**
+ * Equivalent to intersect() for rays that start above the track, but
+ * cheaper: the track vertices are evenly spaced, so the segments under
+ * the ray are found directly from its x range and each is tested against
+ * its precomputed line equation. Segments are visited in the direction
+ * of the ray, so the first hit is also the nearest one.
+ */
+bool Level::castBeam(const Vector2& from, const Vector2 &to, Vector2 &point) const
+{
+	const float x0 = from.getX(), y0 = from.getY();
+	const float dx = to.getX() - x0, dy = to.getY() - y0;
+	
+	int first = (int)floor(x0 / VERTEX_DIST);
+	int last = (int)floor(to.getX() / VERTEX_DIST);
+	
+	if(first < 0) first = 0;
+	if(first > MAX_VERTICES - 2) first = MAX_VERTICES - 2;
+	if(last < 0) last = 0;
+	if(last > MAX_VERTICES - 2) last = MAX_VERTICES - 2;
+	
+	const int step = last >= first ? 1 : -1;
+	
+	for(int i = first; ; i += step)
+	{
+		// from + t * (to - from) lies on the segment's line when
+		// t * (dy - slope * dx) == slope * x0 + intercept - y0
+		float den = dy - slopes[i] * dx;
+		float num = slopes[i] * x0 + intercepts[i] - y0;
+		
+		if(den < 0.0)
+		{
+			den = -den;
+			num = -num;
+		}
+		
+		if(num >= 0.0 && num <= den && den > 0.0)
+		{
+			float t = num / den;
+			float x = x0 + t * dx;
+			
+			if(x >= vertices[i].getX() && x <= vertices[i+1].getX())
+			{
+				point = Vector2(x, y0 + t * dy);
+				return true;
+			}
+		}
+		
+		if(i == last) break;
+	}
+	
+	return false;
+}
+
+// Index of the track segment under x, or -1 if x is off the track
+int Level::segmentAt(float x) const
+{
+	int i = (int)floor(x / VERTEX_DIST);
+	if(i == MAX_VERTICES - 1 && x <= vertices[i].getX()) return i - 1;
+	if(i < 0 || i >= MAX_VERTICES - 1) return -1;
+	return i;
+}
+
+/// Get the height of the track at x
+/**
+ * Reads the segment under x directly from the vertex array. Returns 0.0
+ * outside the track.
+ */
 float Level::getHeight(float x) const
 {
-	Vector2 point;
-	const Vector2 v1(x, 1000.0);
-	const Vector2 v2(x, -1000.0);
+	int i = segmentAt(x);
+	if(i < 0) return 0.0;
+	
+	return slopes[i] * x + intercepts[i];
+}
+
+/// Get the track height at n positions at once
+void Level::getHeights(const float *x, float *heights, int n) const
+{
+	for(int j = 0; j < n; j++)
+	{
+		int i = segmentAt(x[j]);
+		heights[j] = i < 0 ? 0.0 : slopes[i] * x[j] + intercepts[i];
+	}
+}
+
+/// Get the slope (dy/dx) of the track at x, 0.0 outside the track
+float Level::getSlope(float x) const
+{
+	int i = segmentAt(x);
+	if(i < 0) return 0.0;
 	
-	if(!intersect(v1,v2,point)) return 0.0;
-	return point.getY();
+	return slopes[i];
 }
 
 bool Level::segmentIsect(float x11, float y11, float x12, float y12, float x21, float y21, float x22, float y22, float *x, float *y)
@@ -131,10 +216,16 @@ int Level::init()
 
 void Level::generate(int seed)
 {
-	Terrain::srandom(seed);
+	terrain.srandom(seed);
 	generate();
 }
 
+/// Generate the terrain on a pool of threads, NULL for the calling thread
+void Level::setWorkerPool(WorkerPool *pool)
+{
+	terrain.setWorkerPool(pool);
+}
+
 void Level::generate()
 {
 	terrain.generate();
@@ -155,57 +246,65 @@ void Level::generate()
 		vertices[i] = Vector2(i * VERTEX_DIST, terrain.getHeight(i, ZERO_DEPTH) * Terrain::HEIGHT_SCALE);
 	}
 	
-	terrain.createLists();
+	computeSegments();
 }
 
-bool Level::ellipseSegmentIsect(const Vector2& center, float angle, float major, float minor, const Vector2 &start, const Vector2 &end, Vector2& point, Vector2& normal, Vector2& delta)
+// Contact of the unit circle with the segment from v1 to v2
+static bool circleSegmentIsect(const Vector2 &v1, const Vector2 &v2, Vector2 &point, Vector2 &delta)
 {
-	Vector2 v1, v2;
-	
-	v1 = start - center;
-	v1.rotate(-angle);
-	v1 = Vector2(v1.getX() / major, v1.getY() / minor);
-	
-	v2 = end - center;
-	v2.rotate(-angle);
-	v2 = Vector2(v2.getX() / major, v2.getY() / minor);
-	
 	Vector2 d = v2 - v1;
-	float ld = d.length();
+	float dd = d * d;
 	
-	float t = (-v1) * d / (ld * ld);
+	float t = (-v1) * d / dd;
 	
 	if(t > 0.0 && t < 1.0)
 	{
 		point = v1 + t * d;
-		if(point.length() > 1.0) return false;
+		if(point * point > 1.0) return false;
 		
 		delta = point;
 		point.normalize();
 		delta = point - delta;
 	} else
 	{
-		if(v1.length() > 1.0 && v2.length() > 1.0) return false;
+		if(v1 * v1 > 1.0 && v2 * v2 > 1.0) return false;
 		
 		float a, b, c, discr;
 		
-		a = d * d;
+		a = dd;
 		b = 2.0 * (v1 * d);
 		c = (v1 * v1) - 1.0;
 		
 		discr = b * b - 4.0 * a * c;
 		if(discr < 0.0) return false;
 		
-		t = (-b - sqrt(discr)) / (2.0 * a);
-		if(t < 0.0 || t > 1.0) t = (-b + sqrt(discr)) / (2.0 * a);
+		discr = sqrt(discr);
+		t = (-b - discr) / (2.0 * a);
+		if(t < 0.0 || t > 1.0) t = (-b + discr) / (2.0 * a);
 		if(t < 0.0 || t > 1.0) return false;
 		
 		point = v1 + t * d;
 		
-		if(v2.length() < 1.0) delta = (t - 1.0) * d;
+		if(v2 * v2 < 1.0) delta = (t - 1.0) * d;
 		else delta = t * d;
 	}
 	
+	return true;
+}
+
+bool Level::ellipseSegmentIsect(const Vector2& center, float angle, float major, float minor, const Vector2 &start, const Vector2 &end, Vector2& point, Vector2& normal, Vector2& delta)
+{
+	Vector2 v1, v2;
+	
+	v1 = start - center;
+	v1.rotate(-angle);
+	v1 = Vector2(v1.getX() / major, v1.getY() / minor);
+	
+	v2 = end - center;
+	v2.rotate(-angle);
+	v2 = Vector2(v2.getX() / major, v2.getY() / minor);
+	
+	if(!circleSegmentIsect(v1, v2, point, delta)) return false;
 	
 	// calculate normal
 	normal = -point;
@@ -223,7 +322,20 @@ bool Level::ellipseSegmentIsect(const Vector2& center, float angle, float major,
 	return true;
 }
 
-bool Level::ellipseIntersect(const Vector2& center, float angle, float major, float minor, Vector2& point, Vector2& normal, Vector2& delta)
+/// Find the deepest contact of an ellipse with the track
+/**
+	The vertices of the segments under the ellipse are transformed to
+	the ellipse's own coordinates once, where it is a unit circle, and
+	every segment is tested in one pass. Segments farther from the
+	center than the major axis are skipped using the precomputed
+	directions and lengths. Of the segments that touch, the one that
+	needs the longest move out of the track wins.
+	@param point	set to the contact point
+	@param normal	set to the contact normal, pointing towards the ellipse
+	@param delta	set to how far the ellipse is in the track
+	@return		true if the ellipse touches the track
+*/
+bool Level::ellipseIntersect(const Vector2& center, float angle, float major, float minor, Vector2& point, Vector2& normal, Vector2& delta) const
 {
 	float x1, x2;
 	int min, max;
@@ -237,28 +349,155 @@ bool Level::ellipseIntersect(const Vector2& center, float angle, float major, fl
 	max = (int)(MAX(x1,x2) / VERTEX_DIST) + 2;
 	if(max >= MAX_VERTICES) max = MAX_VERTICES - 1;
 	
-	for(int i = min; i < max; i++)
+	const float c = cos(angle), s = sin(angle);
+	const float sx = 1.0 / major, sy = 1.0 / minor;
+	
+	Vector2 v[SPAN];
+	Vector2 p, d;
+	float depth = -1.0;
+	
+	for(int first = min; first < max; first += SPAN - 1)
 	{
-		if(ellipseSegmentIsect(center, angle, major, minor, vertices[i], vertices[i+1], point, normal, delta)) return true;
+		const int last = MIN(first + SPAN - 1, max);
+		
+		for(int i = first; i <= last; i++)
+		{
+			const Vector2 r = vertices[i] - center;
+			v[i - first] = Vector2((c * r.getX() + s * r.getY()) * sx, (c * r.getY() - s * r.getX()) * sy);
+		}
+		
+		for(int i = first; i < last; i++)
+		{
+			// the ellipse is inside a circle of radius major
+			const Vector2 r = center - vertices[i];
+			const float along = r * directions[i];
+			const float across = r ^ directions[i];
+			if(ABS(across) > major || along < -major || along > lengths[i] + major) continue;
+			
+			if(!circleSegmentIsect(v[i - first], v[i - first + 1], p, d)) continue;
+			
+			const float dx = d.getX() * major, dy = d.getY() * minor;
+			if(dx * dx + dy * dy <= depth) continue;
+			
+			depth = dx * dx + dy * dy;
+			point = p;
+			delta = d;
+		}
 	}
 	
-	return false;
-}
-
-float Level::getWidth()
-{
-	return MAX_VERTICES * VERTEX_DIST;
+	if(depth < 0.0) return false;
+	
+	// transform back to world coordinates
+	normal = Vector2(-c * point.getX() + s * point.getY(), -s * point.getX() - c * point.getY());
+	
+	point = Vector2(point.getX() * major, point.getY() * minor);
+	point = Vector2(c * point.getX() - s * point.getY(), s * point.getX() + c * point.getY()) + center;
+	
+	delta = Vector2(delta.getX() * major, delta.getY() * minor);
+	delta = Vector2(c * delta.getX() - s * delta.getY(), s * delta.getX() + c * delta.getY());
+	
+	return true;
 }
 
-void Level::drawRadar()
+/// Find where an ellipse moving from one point to another first touches the track
+/**
+	Continuous version of ellipseIntersect for fast moving crafts, which
+	could pass through the track between two ticks. The ellipse keeps its
+	angle while it moves. In the ellipse's own coordinates it is a unit
+	circle, so the first contact with each segment is where the circle
+	reaches either the segment's line or one of its end points.
+	Segments already touching the ellipse at the start are ignored.
+	@param t	set to the fraction of the move made before the contact
+	@param point	set to the contact point
+	@param normal	set to the contact normal, pointing towards the ellipse
+	@return		true if the ellipse touches the track on the way
+*/
+bool Level::ellipseSweep(const Vector2& from, const Vector2& to, float angle, float major, float minor, float &t, Vector2& point, Vector2& normal) const
 {
-	glBegin(GL_TRIANGLE_STRIP);
+	int min = (int)((MIN(from.getX(), to.getX()) - major) / VERTEX_DIST) - 1;
+	if(min < 0) min = 0;
 	
-	for(int i = 0; i < MAX_VERTICES; i++)
+	int max = (int)((MAX(from.getX(), to.getX()) + major) / VERTEX_DIST) + 2;
+	if(max >= MAX_VERTICES) max = MAX_VERTICES - 1;
+	
+	Vector2 d = to - from;
+	d.rotate(-angle);
+	d = Vector2(d.getX() / major, d.getY() / minor);
+	const float dd = d * d;
+	if(dd == 0.0) return false;
+	
+	bool hit = false;
+	Vector2 contact, contactNormal;
+	t = 2.0;
+	
+	for(int i = min; i < max; i++)
 	{
-		glVertex2f(vertices[i].getX(), 0.0);
-		glVertex2f(vertices[i].getX(), vertices[i].getY());
+		Vector2 a = vertices[i] - from;
+		a.rotate(-angle);
+		a = Vector2(a.getX() / major, a.getY() / minor);
+		
+		Vector2 b = vertices[i+1] - from;
+		b.rotate(-angle);
+		b = Vector2(b.getX() / major, b.getY() / minor);
+		
+		// the circle reaching the segment's line
+		Vector2 e = b - a;
+		Vector2 n = e.normalVector().unitVector();
+		float dist = -(a * n);
+		float dn = d * n;
+		
+		if(ABS(dist) > 1.0 && dist * dn < 0.0)
+		{
+			float side = dist > 0.0 ? 1.0 : -1.0;
+			float s = (side - dist) / dn;
+			Vector2 q = s * d - side * n;
+			float u = ((q - a) * e) / (e * e);
+			
+			if(s >= 0.0 && s < t && u >= 0.0 && u <= 1.0)
+			{
+				t = s;
+				contact = q;
+				contactNormal = side * n;
+				hit = true;
+			}
+		}
+		
+		// the circle reaching an end point
+		for(int j = 0; j < 2; j++)
+		{
+			const Vector2 &p = j ? b : a;
+			float c = p * p - 1.0;
+			if(c <= 0.0) continue;
+			
+			float dp = d * p;
+			float discr = dp * dp - dd * c;
+			if(discr < 0.0) continue;
+			
+			float s = (dp - sqrt(discr)) / dd;
+			if(s >= 0.0 && s < t)
+			{
+				t = s;
+				contact = p;
+				contactNormal = s * d - p;
+				hit = true;
+			}
+		}
 	}
 	
-	glEnd();
+	if(!hit || t > 1.0) return false;
+	
+	// transform back to world coordinates
+	point = Vector2(contact.getX() * major, contact.getY() * minor);
+	point.rotate(angle);
+	point = point + from;
+	
+	normal = contactNormal;
+	normal.rotate(angle);
+	
+	return true;
+}
+
+float Level::getWidth()
+{
+	return MAX_VERTICES * VERTEX_DIST;
 }
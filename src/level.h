@@ -7,9 +7,13 @@ public:
 	Level();
 	
 	int init();
+	int initGraphics();
 	
 	void generate(int seed);
 	void generate();
+	void createLists();
+	
+	void setWorkerPool(WorkerPool *pool);
 	
 	float getWidth();
 	
@@ -19,8 +23,12 @@ public:
 	void drawRadar();
 	
 	bool intersect(const Vector2& v1, const Vector2 &v2, Vector2 &point) const;
-	bool ellipseIntersect(const Vector2& center, float angle, float major, float minor, Vector2& point, Vector2& normal, Vector2 &delta);
+	bool castBeam(const Vector2& from, const Vector2 &to, Vector2 &point) const;
+	bool ellipseIntersect(const Vector2& center, float angle, float major, float minor, Vector2& point, Vector2& normal, Vector2 &delta) const;
+	bool ellipseSweep(const Vector2& from, const Vector2& to, float angle, float major, float minor, float &t, Vector2& point, Vector2& normal) const;
 	float getHeight(float x) const;
+	void getHeights(const float *x, float *heights, int n) const;
+	float getSlope(float x) const;
 
 	static Level &getInstance();
 
@@ -35,7 +43,22 @@ private:
 	static const int MAX_VERTICES = 512;
 	static const float VERTEX_DIST;
 	
+	/// Vertices transformed at a time by ellipseIntersect
+	static const int SPAN = 16;
+	
+	void computeSegments();
+	int segmentAt(float x) const;
+	
 	Vector2 vertices[MAX_VERTICES];
+	
+	/// Line equation y = slope * x + intercept of each track segment
+	float slopes[MAX_VERTICES];
+	float intercepts[MAX_VERTICES];
+	
+	/// Unit direction and length of each track segment
+	Vector2 directions[MAX_VERTICES];
+	float lengths[MAX_VERTICES];
+	
 	Terrain terrain;
 };
 
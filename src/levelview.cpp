@@ -0,0 +1,67 @@
+#include "SDL_opengl.h"
+#include <AL/al.h>
+#include <cmath>
+
+#include "antigrav.h"
+
+/*
+	Drawing of the level. Kept apart from level.cpp so that the physics
+	can be linked without OpenGL.
+*/
+
+int Level::initGraphics()
+{
+	if(terrain.initGraphics() != 0) return -1;
+	
+	return 0;
+}
+
+// Build the terrain display lists, must be called after generate()
+void Level::createLists()
+{
+	terrain.createLists();
+}
+
+void Level::draw3d(const float *eye, const float *at, float fovDiag)
+{
+	glPushMatrix();
+	glTranslatef(0.0, 0.0, -(float)ZERO_DEPTH/2.0);
+	terrain.drawLists(eye, at, fovDiag, -(float)ZERO_DEPTH/2.0);
+	
+	glEnable(GL_TEXTURE_2D);
+	terrain.drawRoad(ZERO_DEPTH);
+	glDisable(GL_TEXTURE_2D);
+	
+	glPopMatrix();
+}
+
+void Level::draw2d()
+{
+	glBegin(GL_LINE_STRIP);
+	for(int i = 0; i < MAX_VERTICES; i++) glVertex2fv(vertices[i].getData());
+	glEnd();
+}
+
+// The radar is only a few hundred pixels wide, so sample the track coarsely
+void Level::drawRadar()
+{
+	static const int RADAR_SAMPLES = 128;
+	float x[RADAR_SAMPLES], y[RADAR_SAMPLES];
+	
+	for(int i = 0; i < RADAR_SAMPLES; i++)
+	{
+		x[i] = i * vertices[MAX_VERTICES-1].getX() / (RADAR_SAMPLES - 1);
+	}
+	
+	getHeights(x, y, RADAR_SAMPLES);
+	
+	glBegin(GL_TRIANGLE_STRIP);
+	
+	for(int i = 0; i < RADAR_SAMPLES; i++)
+	{
+		glVertex2f(x[i], 0.0);
+		glVertex2f(x[i], y[i]);
+	}
+	
+	glEnd();
+}
@@ -57,11 +57,19 @@ int m3dMaterial::loadFromXML(const TiXmlElement *root)
 	return 0;
 }
 
-void m3dMaterial::bind()
+/// Make this the current material
+/**
+	@param alpha the opacity of the lit surface
+*/
+void m3dMaterial::bind(float alpha)
 {
-	glMaterialfv(GL_FRONT, GL_AMBIENT, ambient);
-	glMaterialfv(GL_FRONT, GL_DIFFUSE, diffuse);
-	glMaterialfv(GL_FRONT, GL_SPECULAR, specular);
+	float a[4] = {ambient[0], ambient[1], ambient[2], alpha};
+	float d[4] = {diffuse[0], diffuse[1], diffuse[2], alpha};
+	float s[4] = {specular[0], specular[1], specular[2], alpha};
+	
+	glMaterialfv(GL_FRONT, GL_AMBIENT, a);
+	glMaterialfv(GL_FRONT, GL_DIFFUSE, d);
+	glMaterialfv(GL_FRONT, GL_SPECULAR, s);
 	glMaterialf(GL_FRONT, GL_SHININESS, shininess*128.0f);
 }
 
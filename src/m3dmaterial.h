@@ -14,7 +14,7 @@ class m3dMaterial
 	int loadFromXML(const TiXmlElement *root);
 	int saveToXML(TiXmlElement *root);
 
-	void bind();
+	void bind(float alpha = 1.0);
 	
 	protected:
 	float ambient[3];
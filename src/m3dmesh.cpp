@@ -220,8 +220,9 @@ void m3dMesh::setTexture(int n, const m3dTexture& tex)
 /// Draw the mesh
 /**
 	Draws this mesh. No child objects are rendered, nor child lights are enabled.
+	@param alpha the opacity of the materials, blending is left to the caller
 */
-void m3dMesh::draw()
+void m3dMesh::draw(float alpha)
 {
 	glPushMatrix();
 // 	transform();
@@ -234,7 +235,7 @@ void m3dMesh::draw()
 
 	if(faces[0].material != -1)
 	{
-		materials[faces[0].material].bind();
+		materials[faces[0].material].bind(alpha);
 	}
 	prevMaterial = faces[0].material;
 
@@ -266,10 +267,10 @@ void m3dMesh::draw()
 		{
 			if(face->material != -1)
 			{
-				materials[face->material].bind();
+				materials[face->material].bind(alpha);
 			} else
 			{
-				m3dMaterial().bind();
+				m3dMaterial().bind(alpha);
 			}
 
 			prevMaterial = face->material;
@@ -46,7 +46,7 @@ public:
 	const m3dTexture &getTexture(int n) const;
 	void setTexture(int n, const m3dTexture &tex);
 	
-	void draw();
+	void draw(float alpha = 1.0);
 	
 private:
 	struct Vertex *verts;
@@ -3,6 +3,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string>
+#include <vector>
 #include <png.h>
 
 using namespace std;
@@ -13,6 +14,18 @@ using namespace std;
 #include "m3dmesh.h"
 
 #include "extensions.h"
+#include "workerpool.h"
+
+/// An image decoded ahead of time by m3dTexture::preload()
+struct DecodedImage
+{
+	string filename;
+	unsigned char *data;
+	png_uint_32 width, height;
+	int result;
+};
+
+static vector<DecodedImage> decoded;
 
 /// Create a new null object
 /**
@@ -205,6 +218,26 @@ void m3dTexture::pngReadCallbackSTDIO(png_structp pngPtr, png_bytep data, png_si
 	@return 0 on success, -1 on failure
 */
 int m3dTexture::loadPNG(const char *filename, unsigned char **data, png_uint_32 *width, png_uint_32 *height)
+{
+	int result;
+
+	// take the image if it was preloaded
+	for(unsigned int i = 0; i < decoded.size(); i++)
+	{
+		if(decoded[i].filename != filename) continue;
+
+		*data = decoded[i].data;
+		*width = decoded[i].width;
+		*height = decoded[i].height;
+		result = decoded[i].result;
+		decoded.erase(decoded.begin() + i);
+		return result;
+	}
+
+	return readPNG(filename, data, width, height);
+}
+
+int m3dTexture::readPNG(const char *filename, unsigned char **data, png_uint_32 *width, png_uint_32 *height)
 {
 	FILE *f;
 	int result;
@@ -463,6 +496,42 @@ GLuint m3dTexture::loadTexture(const char *filename)
 	return tex;
 }
 
+void m3dTexture::decodeJob(int n, void *arg)
+{
+	DecodedImage &image = ((DecodedImage *)arg)[n];
+	image.result = readPNG(image.filename.c_str(), &image.data, &image.width, &image.height);
+}
+
+/// Decode PNG images on a pool of threads
+/**
+	The images are kept until loadPNG() or one of the texture loaders
+	asks for them, so the OpenGL uploads stay on the calling thread while
+	the decoding runs in parallel. Call this before loading the textures,
+	from the thread that loads them, and freePreloaded() after.
+*/
+void m3dTexture::preload(int num, const char *filenames[], WorkerPool *pool)
+{
+	if(num <= 0) return;
+
+	vector<DecodedImage> images(num);
+	for(int i = 0; i < num; i++)
+	{
+		images[i].filename = filenames[i];
+		images[i].data = NULL;
+	}
+
+	pool->run(num, decodeJob, &images[0]);
+
+	decoded.insert(decoded.end(), images.begin(), images.end());
+}
+
+/// Drop the preloaded images nobody asked for
+void m3dTexture::freePreloaded()
+{
+	for(unsigned int i = 0; i < decoded.size(); i++) delete[] decoded[i].data;
+	decoded.clear();
+}
+
 m3dTexture &m3dTexture::operator=(const m3dTexture &t)
 {
 	if(&t == this) return *this;
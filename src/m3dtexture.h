@@ -5,6 +5,8 @@
 #include <string>
 #include <png.h>
 
+class WorkerPool;
+
 struct TextureUnit
 {
 	std::string filename;
@@ -39,6 +41,9 @@ public:
 	static int screenshot(const char *filename);
 	
 	static GLuint loadTexture(const char *filename);
+	
+	static void preload(int num, const char *filenames[], WorkerPool *pool);
+	static void freePreloaded();
 
 private:
 	struct TextureUnit *texUnits;
@@ -48,6 +53,9 @@ private:
 	static void pngWriteCallbackSTDIO(png_structp pngPtr, png_bytep data, png_size_t length);
 	static void pngFlushCallbackSTDIO(png_structp pngPtr);
 	
+	static int readPNG(const char *filename, unsigned char **data, png_uint_32 *width, png_uint_32 *height);
+	static void decodeJob(int n, void *arg);
+	
 	static int loadPNG(unsigned char **data, png_uint_32 *width, png_uint_32 *height, void *handle, void (*pngReadCallback)(png_structp ctx, png_bytep area, png_size_t size));
 	static int savePNG(const unsigned char *data, png_uint_32 width, png_uint_32 height, void *handle, void (*pngWriteCallback)(png_structp pngPtr, png_bytep data, png_size_t length), void (*pngFlushCallback)(png_structp pngPtr));
 };
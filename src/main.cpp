@@ -7,8 +7,10 @@
 #include <unistd.h>
 #include <cstdlib>
 #include <cstdio>
+#include <cstring>
 #include <cmath>
 #include <ctime>
+#include <climits>
 
 #include <getopt.h>
 
@@ -25,13 +27,30 @@ MFNGLACTIVETEXTUREARBPROC mglActiveTextureARB = NULL;
 bool opt_fullscreen = true;
 bool opt_fsaa = false;
 int opt_width = 1024;
+bool opt_replay = false;
+char opt_record[PATH_MAX];
+char opt_ghost[PATH_MAX];
 const char *help_msg =
 "Usage: antigrav [options]\n\
 Options:\n\
   -h, --help\t\tprint this help, then exit\n\
   -f, --fsaa\t\tenable full screen antialiasing\n\
   -w, --windowed\trun in windowed mode\n\
-  -r, --resolution=RES\tset resolution to RES, 1024 for 1024x768, 800 for 800x600, etc\n";
+  -r, --resolution=RES\tset resolution to RES, 1024 for 1024x768, 800 for 800x600, etc\n\
+  -R, --record=PREFIX\tsave the controls of race N to PREFIXN.rpl\n\
+  -P, --replay=FILE\tplay the race recorded in FILE, then exit\n\
+  -G, --ghost=FILE\trace against the ghost saved in FILE\n\
+  -S, --save-ghost=PREFIX\tsave the first player of race N as a ghost to PREFIXN.ghost\n\
+  -b, --bots=N\t\trace against N computer players, up to 4\n";
+
+// Files are written after changing to the data directory, so make their
+// names absolute
+void absolute_path(char *path, const char *name)
+{
+	if(name[0] == '/' || getcwd(path, PATH_MAX) == NULL) path[0] = '\0';
+	else strncat(path, "/", PATH_MAX - strlen(path) - 1);
+	strncat(path, name, PATH_MAX - strlen(path) - 1);
+}
 
 int parse_args(int argc, char *argv[])
 {
@@ -44,10 +63,15 @@ int parse_args(int argc, char *argv[])
 			{"fsaa", no_argument, 0, 'f'},
 			{"windowed", no_argument, 0, 'w'},
 			{"resolution", required_argument, 0, 'r'},
+			{"record", required_argument, 0, 'R'},
+			{"replay", required_argument, 0, 'P'},
+			{"ghost", required_argument, 0, 'G'},
+			{"save-ghost", required_argument, 0, 'S'},
+			{"bots", required_argument, 0, 'b'},
 			{0, 0, 0, 0}
 		};
 
-		int c = getopt_long(argc, argv, "hfwr:", long_options, &option_index);
+		int c = getopt_long(argc, argv, "hfwr:R:P:G:S:b:", long_options, &option_index);
 		if(c == -1)
 			break;
 		
@@ -66,6 +90,24 @@ int parse_args(int argc, char *argv[])
 			case 'r':
 				opt_width = atoi(optarg);
 				break;
+			case 'R':
+				absolute_path(opt_record, optarg);
+				Game::getInstance().setRecordFile(opt_record);
+				break;
+			case 'P':
+				if(Game::getInstance().setReplay(optarg)) exit(1);
+				opt_replay = true;
+				break;
+			case 'G':
+				if(Game::getInstance().setGhost(optarg)) exit(1);
+				break;
+			case 'S':
+				absolute_path(opt_ghost, optarg);
+				Game::getInstance().setGhostRecordFile(opt_ghost);
+				break;
+			case 'b':
+				Game::getInstance().setNumBots(atoi(optarg));
+				break;
 			default:
 				puts(help_msg);
 				return 1;
@@ -156,6 +198,12 @@ int main(int argc, char *argv[])
 	if(game.init()) return 1;
 	if(Menu::init()) return 1;
 
+	if(opt_replay)
+	{
+		game.gameLoop();
+		return 0;
+	}
+	
 	Menu menu;
 	while(1) {
 		if(menu.show())
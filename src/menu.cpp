@@ -40,8 +40,10 @@ int Menu::show()
 		game.getPlayer(p).setLocal(true);
 		game.getPlayer(p).setActive(false);
 		game.getPlayer(p).setName(name);
+		sprintf(name,"Botti %d",p+1);
 		game.getPlayer(p+4).setLocal(false);
-		game.getPlayer(p+4).setActive(false);
+		game.getPlayer(p+4).setActive(p < game.getNumBots());
+		game.getPlayer(p+4).setName(name);
 		anim[p]=0;
 	}
 	startanim = 0;
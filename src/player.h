@@ -1,6 +1,8 @@
 #ifndef _PLAYER_H_
 #define _PLAYER_H_
 
+class m3dTexture;
+
 class Player
 {
 public:
@@ -25,16 +27,19 @@ public:
 	Craft &getCraft();
 	
 	bool update(float dt);
+	void updateSound();
 
 	bool isActive() const;
 	bool isLocal() const;
     bool isFinished() const;
+	void setFinishTime(double t);
+	double getFinishTime() const;
     const char *getName() const;
 	
-	void drawHud(const GLint *viewport, int activePlayers, int num);
+	void drawHud(const int *viewport, int activePlayers, int num);
 	
-	void setSource(ALuint src);
-	ALuint getSource() const;
+	void setSource(unsigned int src);
+	unsigned int getSource() const;
 	
 	static void setEngineVolume(float vol);
 private:
@@ -49,13 +54,15 @@ private:
 	bool active;
 	bool local;
 	bool finished;
+	double finishTime;
 
-	static GLuint gauges,needle,fuel;
-	static ALuint buffer;
+	// OpenGL and OpenAL handles, only touched by playerview.cpp
+	static unsigned int gauges,needle,fuel;
+	static unsigned int buffer;
 	
 	static float engineVolume;
 	
-	ALuint source;
+	unsigned int source;
 };
 
 #endif
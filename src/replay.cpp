@@ -0,0 +1,340 @@
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+
+#include "sim.h"
+
+/*
+	File format, all integers little endian:
+
+		"AGRP", version (1 byte)
+		seed (4 bytes), tick length (float, 4 bytes)
+		integrator (1 byte), max sub-steps, tolerance (float, 4 bytes)
+		number of players, number of ticks
+		for each player: flags (1 byte), number of runs,
+			each run as (length << 3) | controls
+
+	Fields without a size are unsigned LEB128 variable length integers.
+*/
+
+static const char MAGIC[4] = {'A', 'G', 'R', 'P'};
+
+// an hour at 10 kHz
+static const unsigned int MAX_TICKS = 36000000;
+
+static void writeVarint(FILE *out, unsigned int v)
+{
+	while(v >= 0x80)
+	{
+		fputc((v & 0x7f) | 0x80, out);
+		v >>= 7;
+	}
+	fputc(v, out);
+}
+
+static void writeUint32(FILE *out, unsigned int v)
+{
+	for(int i = 0; i < 4; i++) fputc((v >> (8 * i)) & 0xff, out);
+}
+
+static void writeFloat(FILE *out, float f)
+{
+	unsigned int v;
+	memcpy(&v, &f, sizeof(v));
+	writeUint32(out, v);
+}
+
+static bool readVarint(FILE *in, unsigned int &v)
+{
+	v = 0;
+	for(int shift = 0; shift < 32; shift += 7)
+	{
+		int c = fgetc(in);
+		if(c == EOF) return false;
+		v |= (unsigned int)(c & 0x7f) << shift;
+		if(!(c & 0x80)) return true;
+	}
+	return false;
+}
+
+static bool readUint32(FILE *in, unsigned int &v)
+{
+	v = 0;
+	for(int i = 0; i < 4; i++)
+	{
+		int c = fgetc(in);
+		if(c == EOF) return false;
+		v |= (unsigned int)c << (8 * i);
+	}
+	return true;
+}
+
+static bool readFloat(FILE *in, float &f)
+{
+	unsigned int v;
+	if(!readUint32(in, v)) return false;
+	memcpy(&f, &v, sizeof(f));
+	return true;
+}
+
+Replay::Replay()
+{
+	seed = 0;
+	dt = 0.0;
+	integrator = World::INTEGRATE_BATCH;
+	maxSubSteps = 1;
+	tolerance = 0.0;
+	ticks = 0;
+}
+
+/// Start recording a race
+/**
+	Stores the world's level seed, settings and roster. Call this after
+	World::reset(), with the length of the ticks the race will be run at.
+*/
+void Replay::start(World &world, float tickLength)
+{
+	seed = world.getSeed();
+	dt = tickLength;
+	integrator = world.getIntegrator();
+	maxSubSteps = world.getMaxSubSteps();
+	tolerance = world.getTolerance();
+	ticks = 0;
+
+	tracks.resize(world.getNumPlayers());
+	for(unsigned int i = 0; i < tracks.size(); i++)
+	{
+		Player &player = world.getPlayer(i);
+		tracks[i].flags = (player.isActive() ? FLAG_ACTIVE : 0) | (player.isLocal() ? FLAG_LOCAL : 0);
+		tracks[i].runs.clear();
+		tracks[i].run = 0;
+		tracks[i].left = 0;
+	}
+}
+
+/// Record the controls for the next tick
+/**
+	Call this once before every World::update().
+*/
+void Replay::record(World &world)
+{
+	for(unsigned int i = 0; i < tracks.size(); i++)
+	{
+		Craft &craft = world.getPlayer(i).getCraft();
+		int controls = 0;
+		for(int c = 0; c < Craft::NUM_CONTROLS; c++)
+		{
+			if(craft.getControl(c)) controls |= 1 << c;
+		}
+
+		std::vector<Run> &runs = tracks[i].runs;
+		if(!runs.empty() && runs.back().controls == controls)
+		{
+			runs.back().length++;
+		} else
+		{
+			Run r = {controls, 1};
+			runs.push_back(r);
+		}
+	}
+
+	ticks++;
+}
+
+/// Write the replay to a file
+/**
+	@return 0 on success, -1 if the file can't be written
+*/
+int Replay::save(const char *filename) const
+{
+	FILE *out = fopen(filename, "wb");
+	if(out == NULL)
+	{
+		fprintf(stderr, "Can't open %s for writing\n", filename);
+		return -1;
+	}
+
+	fwrite(MAGIC, 1, sizeof(MAGIC), out);
+	fputc(FORMAT_VERSION, out);
+	writeUint32(out, seed);
+	writeFloat(out, dt);
+	fputc(integrator, out);
+	writeVarint(out, maxSubSteps);
+	writeFloat(out, tolerance);
+	writeVarint(out, tracks.size());
+	writeVarint(out, ticks);
+
+	for(unsigned int i = 0; i < tracks.size(); i++)
+	{
+		const std::vector<Run> &runs = tracks[i].runs;
+		fputc(tracks[i].flags, out);
+		writeVarint(out, runs.size());
+		for(unsigned int r = 0; r < runs.size(); r++)
+		{
+			writeVarint(out, (runs[r].length << Craft::NUM_CONTROLS) | runs[r].controls);
+		}
+	}
+
+	if(fclose(out) != 0)
+	{
+		fprintf(stderr, "Can't write %s\n", filename);
+		return -1;
+	}
+
+	return 0;
+}
+
+/// Read a replay and rewind it to the first tick
+/**
+	@return 0 on success, -1 if the file can't be read or is not a valid
+	replay
+*/
+int Replay::load(const char *filename)
+{
+	FILE *in = fopen(filename, "rb");
+	if(in == NULL)
+	{
+		fprintf(stderr, "Can't open %s\n", filename);
+		return -1;
+	}
+
+	char magic[sizeof(MAGIC)];
+	unsigned int s, numTracks, numTicks, subSteps;
+	int version, integ;
+	bool ok = fread(magic, 1, sizeof(magic), in) == sizeof(magic) && memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+
+	if(ok && (version = fgetc(in)) != FORMAT_VERSION)
+	{
+		fprintf(stderr, "%s: unsupported replay version %d\n", filename, version);
+		fclose(in);
+		return -1;
+	}
+
+	ok = ok && readUint32(in, s) && readFloat(in, dt) && (integ = fgetc(in)) != EOF &&
+		readVarint(in, subSteps) && readFloat(in, tolerance) &&
+		readVarint(in, numTracks) && readVarint(in, numTicks);
+	ok = ok && dt > 0.0 && numTicks <= MAX_TICKS && (integ == World::INTEGRATE_SCALAR ||
+		integ == World::INTEGRATE_BATCH || integ == World::INTEGRATE_ADAPTIVE);
+
+	// every track takes at least two bytes and every run one, so the
+	// counts can't be larger than what is left of the file
+	long here = ftell(in), left = 0;
+	if(ok && here >= 0 && fseek(in, 0, SEEK_END) == 0) left = ftell(in) - here;
+	ok = ok && fseek(in, here, SEEK_SET) == 0 && left > 0;
+	ok = ok && numTracks > 0 && numTracks <= (unsigned long)left / 2;
+
+	if(ok)
+	{
+		seed = (int)s;
+		integrator = integ;
+		maxSubSteps = subSteps;
+		ticks = numTicks;
+		tracks.resize(numTracks);
+	}
+
+	for(unsigned int i = 0; ok && i < tracks.size(); i++)
+	{
+		Track &track = tracks[i];
+		unsigned int numRuns;
+
+		track.flags = fgetc(in);
+		ok = track.flags != EOF && readVarint(in, numRuns) &&
+			numRuns <= numTicks && numRuns <= (unsigned long)left;
+
+		track.runs.resize(ok ? numRuns : 0);
+
+		unsigned int total = 0;
+		for(unsigned int r = 0; ok && r < numRuns; r++)
+		{
+			unsigned int v;
+			ok = readVarint(in, v);
+			track.runs[r].controls = v & ((1 << Craft::NUM_CONTROLS) - 1);
+			track.runs[r].length = v >> Craft::NUM_CONTROLS;
+			ok = ok && (unsigned int)track.runs[r].length <= numTicks - total;
+			total += track.runs[r].length;
+		}
+
+		// every player has controls for every tick
+		ok = ok && total == numTicks;
+
+		track.run = 0;
+		track.left = track.runs.empty() ? 0 : track.runs[0].length;
+	}
+
+	fclose(in);
+
+	if(!ok)
+	{
+		fprintf(stderr, "%s is not a valid replay\n", filename);
+		tracks.clear();
+		ticks = 0;
+		return -1;
+	}
+
+	return 0;
+}
+
+/// Prepare a world for playing the replay
+/**
+	Generates the recorded level, applies the recorded settings and
+	activates the recorded players. The roster grows if it is too small
+	for the replay, players beyond the replay's are left out of the
+	race. Call World::reset() afterwards.
+*/
+void Replay::setup(World &world) const
+{
+	world.setIntegrator(integrator);
+	world.setMaxSubSteps(maxSubSteps);
+	world.setTolerance(tolerance);
+
+	if(world.getNumPlayers() < (int)tracks.size()) world.setNumPlayers(tracks.size());
+	world.generate(seed);
+
+	for(int i = 0; i < world.getNumPlayers(); i++)
+	{
+		Player &player = world.getPlayer(i);
+		int flags = i < (int)tracks.size() ? tracks[i].flags : 0;
+		player.setActive(flags & FLAG_ACTIVE);
+		player.setLocal(flags & FLAG_LOCAL);
+	}
+}
+
+/// Set the recorded controls for the next tick
+/**
+	Call this once before every World::update().
+	@return false when the replay has ended, the controls are released then
+*/
+bool Replay::play(World &world)
+{
+	bool playing = false;
+
+	for(unsigned int i = 0; i < tracks.size(); i++)
+	{
+		Track &track = tracks[i];
+		Craft &craft = world.getPlayer(i).getCraft();
+
+		// skip to the run of this tick
+		while(track.left == 0 && track.run + 1 < track.runs.size())
+		{
+			track.run++;
+			track.left = track.runs[track.run].length;
+		}
+
+		int controls = 0;
+		if(track.left > 0)
+		{
+			controls = track.runs[track.run].controls;
+			track.left--;
+			playing = true;
+		}
+
+		for(int c = 0; c < Craft::NUM_CONTROLS; c++) craft.setControl(c, controls & (1 << c));
+	}
+
+	return playing;
+}
+
+int Replay::getSeed() const { return seed; }
+float Replay::getDt() const { return dt; }
+int Replay::getTicks() const { return ticks; }
+int Replay::getNumPlayers() const { return tracks.size(); }
@@ -0,0 +1,66 @@
+#ifndef _REPLAY_H_
+#define _REPLAY_H_
+
+#include <vector>
+
+/// Recorded controls of a race
+/**
+	A replay holds what is needed to simulate a race again: the level
+	seed, the world settings, the roster and the state of every craft's
+	three controls at every tick. Controls change rarely, so each player's
+	bitmasks are stored as runs of equal values, written to disk as
+	variable length integers.
+*/
+class Replay
+{
+public:
+	static const int FORMAT_VERSION = 1;
+
+	Replay();
+
+	void start(World &world, float dt);
+	void record(World &world);
+	int save(const char *filename) const;
+
+	int load(const char *filename);
+	void setup(World &world) const;
+	bool play(World &world);
+
+	int getSeed() const;
+	float getDt() const;
+	int getTicks() const;
+	int getNumPlayers() const;
+
+private:
+	static const int FLAG_ACTIVE = 1;
+	static const int FLAG_LOCAL = 2;
+
+	/// A run of ticks with the same controls pressed
+	struct Run
+	{
+		int controls;
+		int length;
+	};
+
+	/// Controls of one player
+	struct Track
+	{
+		int flags;
+		std::vector<Run> runs;
+
+		// playback position
+		unsigned int run;
+		int left;
+	};
+
+	int seed;
+	float dt;
+	int integrator;
+	int maxSubSteps;
+	float tolerance;
+
+	int ticks;
+	std::vector<Track> tracks;
+};
+
+#endif
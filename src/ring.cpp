@@ -1,31 +1,10 @@
-#include "SDL_opengl.h"
-
-#include <AL/al.h>
 #include <cmath>
+#include <cstring>
 
-#include "antigrav.h"
-
-m3dMesh Ring::mesh;
+#include "sim.h"
+#include "simd.h"
 
 const float Ring::MAXLIFE = 1.0;
-Ring *Ring::rings;
-int Ring::numRings;
-
-int Ring::init()
-{
-    if(mesh.loadFromXML("ring.xml"))
-        return 1;
-
-    rings = new Ring[MAXRINGS];
-    if(!rings)
-        return 1;
-    return 0;
-}
-
-Ring::Ring()
-    : life(0)
-{
-}
 
 Ring::Ring(float x, float y, float ang, const Vector2& vel, const float col[3])
 {
@@ -33,80 +12,121 @@ Ring::Ring(float x, float y, float ang, const Vector2& vel, const float col[3])
     posy = y;
     velx = vel.getX();
     vely = vel.getY();
-    life = MAXLIFE;
     angle = DEG(ang);
 
     color[0] = col[0];
     color[1] = col[1];
     color[2] = col[2];
-    color[3] = 1;
 }
 
-void Ring::update(float t)
+RingList::RingList()
+    : capacity(0), first(0), count(0)
 {
-    if(isAlive()) {
-        posx += velx * t;
-        posy += vely * t;
-        life -= t;
-        if(life<0)
-            color[3]=0;
-        else
-            color[3] = life/MAXLIFE;
-    }
 }
 
-void Ring::draw()
+// Planes are padded by a SIMD_WIDTH so the last lanes can be loaded
+float *RingList::plane(int p)
 {
-    glPushMatrix();
-    glColor4fv(color);
-    glTranslatef(posx,posy,0);
-    glRotatef(angle,0,0,1);
-    glScalef(7,7,7);
-    mesh.draw();
-    glPopMatrix();
+    return &data[p * (capacity + SIMD_WIDTH)];
 }
 
-bool Ring::isAlive() const
+const float *RingList::plane(int p) const
 {
-    return life>0;
+    return &data[p * (capacity + SIMD_WIDTH)];
 }
 
-void Ring::updateAll(float t)
+void RingList::update(float t)
 {
-    for(int i=0;i<MAXRINGS;++i) {
-        if(rings[i].isAlive()) {
-            rings[i].update(t);
-        }
+    if(count == 0)
+        return;
+
+    float *x = plane(X), *y = plane(Y), *life = plane(LIFE);
+    const float *vx = plane(VX), *vy = plane(VY);
+    const simd_t vt = simdSet(t);
+
+    for(int i = first; i < first + count; i += SIMD_WIDTH) {
+        simdStore(x + i, simdAdd(simdLoad(x + i), simdMul(simdLoad(vx + i), vt)));
+        simdStore(y + i, simdAdd(simdLoad(y + i), simdMul(simdLoad(vy + i), vt)));
+        simdStore(life + i, simdSub(simdLoad(life + i), vt));
     }
-}
 
-void Ring::drawAll() {
-    glEnable(GL_BLEND);
-    glDisable(GL_LIGHTING);
-    glBlendFunc(GL_SRC_ALPHA,GL_ONE);
-    for(int i=0;i<MAXRINGS;++i) {
-        if(rings[i].isAlive()) {
-            rings[i].draw();
-        }
+    // the oldest rings are at the front
+    while(count > 0 && life[first] <= 0) {
+        first++;
+        count--;
     }
-    glDisable(GL_BLEND);
-    glEnable(GL_LIGHTING);
-    glBlendFunc(GL_SRC_ALPHA,GL_ONE_MINUS_SRC_ALPHA);
+    if(count == 0)
+        first = 0;
 }
 
-void Ring::addRing(const Ring& ring)
+void RingList::add(const Ring& ring)
 {
-    for(int i=0;i<MAXRINGS;++i) {
-        if(rings[i].isAlive()==false) {
-            rings[i] = ring;
-            break;
-        }
+    if(first + count == capacity) {
+        // move the rings to the front if that frees enough room,
+        // otherwise grow
+        if(count < capacity / 2)
+            reserve(capacity);
+        else
+            reserve(MAX(2 * capacity, RINGS_PER_CRAFT));
     }
+
+    const int i = first + count;
+    plane(X)[i] = ring.posx;
+    plane(Y)[i] = ring.posy;
+    plane(VX)[i] = ring.velx;
+    plane(VY)[i] = ring.vely;
+    plane(LIFE)[i] = Ring::MAXLIFE;
+    plane(ANGLE)[i] = ring.angle;
+    plane(RED)[i] = ring.color[0];
+    plane(GREEN)[i] = ring.color[1];
+    plane(BLUE)[i] = ring.color[2];
+    count++;
+}
+
+/// Make room for at least n rings
+/**
+	The live rings are moved to the start of the planes. World::reset
+	reserves RINGS_PER_CRAFT rings for each craft.
+*/
+void RingList::reserve(int n)
+{
+    if(n < capacity)
+        n = capacity;
+    n = simdRound(n);
+
+    std::vector<float> old;
+    old.swap(data);
+    const int oldCapacity = capacity;
+
+    capacity = n;
+    data.assign(NUM_PLANES * (capacity + SIMD_WIDTH), 0.0);
+
+    for(int p = 0; p < NUM_PLANES && count > 0; p++)
+        memcpy(plane(p), &old[p * (oldCapacity + SIMD_WIDTH) + first], count * sizeof(float));
+    first = 0;
 }
 
-void Ring::resetAll()
+void RingList::reset()
 {
-    for(int i=0;i<MAXRINGS;++i)
-        rings[i] = Ring();
+    first = 0;
+    count = 0;
+}
+
+int RingList::getNumRings() const
+{
+    return count;
+}
+
+/// Hash of the live rings and their order
+unsigned int RingList::hash() const
+{
+    unsigned int h = FNV_BASIS;
+    for(int k=0;k<count;++k) {
+        const int i = first + k;
+        float f[6] = {plane(X)[i], plane(Y)[i], plane(ANGLE)[i], plane(VX)[i], plane(VY)[i], plane(LIFE)[i]};
+        h = fnvHash(h, &k, sizeof(k));
+        h = fnvHash(h, f, sizeof(f));
+    }
+    return h;
 }
 
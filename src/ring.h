@@ -1,33 +1,60 @@
 #ifndef _RING_H_
 #define _RING_H_
 
+#include <vector>
+
+/// A ring left behind by a craft
 class Ring {
 	public:
 		static int init();
 
-		Ring();
 		Ring(float x, float y, float ang, const Vector2& vel, const float col[3]);
-		void update(float t);
-		void draw();
-		bool isAlive() const;
 
-		static void resetAll();
-		static void updateAll(float t);
-		static void drawAll();
-		static void addRing(const Ring& ring);
+		static const float MAXLIFE;
 
 	private:
-		static m3dMesh mesh;
+		friend class RingList;
+
 		float posx,posy,angle;
 		float velx,vely;
-		float life;
-		float color[4];
+		float color[3];
+};
 
-		static const float MAXLIFE;
-		static const int MAXRINGS = 100;
+/// The rings of one world
+/**
+	The rings are kept in structure-of-arrays planes. Every ring lives
+	MAXLIFE seconds, so they die in the order they were added and the
+	live ones are always a run of consecutive slots: add() appends to the
+	run and update() moves all of them SIMD_WIDTH at a time, then drops
+	the dead ones from the front. When the planes are full the run is
+	moved back to the start, or the planes grow, so rings are never lost.
+*/
+class RingList {
+	public:
+		/// Rings a boosting craft has alive at most
+		static const int RINGS_PER_CRAFT = 6;
+
+		RingList();
+
+		void reset();
+		void reserve(int n);
+		void update(float t);
+		void draw();
+		void add(const Ring& ring);
+		int getNumRings() const;
+		unsigned int hash() const;
+
+	private:
+		enum {X, Y, VX, VY, LIFE, ANGLE, RED, GREEN, BLUE, NUM_PLANES};
+
+		float *plane(int p);
+		const float *plane(int p) const;
+
+		std::vector<float> data;
+		int capacity;
 
-		static Ring *rings;
-		static int numRings;
+		// the live rings
+		int first, count;
 };
 
 #endif
@@ -0,0 +1,44 @@
+#include "SDL_opengl.h"
+
+#include <AL/al.h>
+#include <cmath>
+
+#include "antigrav.h"
+
+/*
+	Drawing of rings. Kept apart from ring.cpp so that the physics can
+	be linked without OpenGL.
+*/
+
+static m3dMesh mesh;
+
+int Ring::init()
+{
+    if(mesh.loadFromXML("ring.xml"))
+        return 1;
+    return 0;
+}
+
+void RingList::draw() {
+    if(count == 0)
+        return;
+
+    const float *x = plane(X), *y = plane(Y), *angle = plane(ANGLE), *life = plane(LIFE);
+    const float *r = plane(RED), *g = plane(GREEN), *b = plane(BLUE);
+
+    glEnable(GL_BLEND);
+    glDisable(GL_LIGHTING);
+    glBlendFunc(GL_SRC_ALPHA,GL_ONE);
+    for(int i=first;i<first+count;++i) {
+        glPushMatrix();
+        glColor4f(r[i], g[i], b[i], life[i]/Ring::MAXLIFE);
+        glTranslatef(x[i],y[i],0);
+        glRotatef(angle[i],0,0,1);
+        glScalef(7,7,7);
+        mesh.draw();
+        glPopMatrix();
+    }
+    glDisable(GL_BLEND);
+    glEnable(GL_LIGHTING);
+    glBlendFunc(GL_SRC_ALPHA,GL_ONE_MINUS_SRC_ALPHA);
+}
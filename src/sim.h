@@ -0,0 +1,39 @@
+#ifndef _SIM_H_
+#define _SIM_H_
+
+/*
+	Headers of the simulation library. Nothing included from here may
+	depend on SDL, OpenGL or OpenAL, so that the physics can be built and
+	run on machines without a display or a sound card.
+*/
+
+#define ABS(x) (((x) > 0)?(x):(-(x)))
+#define DEG(x) ((x) * 180.0 / M_PI)
+#define RAD(x) ((x) * M_PI / 180.0)
+#define MIN(x, y) ( ((x) < (y)) ? (x) : (y) )
+#define MAX(x, y) ( ((x) > (y)) ? (x) : (y) )
+
+#ifdef HAVE_CONFIG_H
+#include "../config.h"
+#else
+#define DATADIR "./data"
+#endif
+
+#include "vector2.h"
+#include "fastmath.h"
+#include "terrain.h"
+#include "craft.h"
+#include "craftbatch.h"
+#include "craftgrid.h"
+#include "level.h"
+#include "ring.h"
+#include "player.h"
+#include "world.h"
+#include "replay.h"
+#include "statelog.h"
+#include "ghost.h"
+#include "bot.h"
+#include "workerpool.h"
+
+#endif
+
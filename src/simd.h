@@ -0,0 +1,62 @@
+#ifndef _SIMD_H_
+#define _SIMD_H_
+
+/*
+	Thin wrappers around packed float arithmetic. SSE is used on every
+	x86 target, AVX when the compiler is told to (eg. CXXFLAGS=-mavx),
+	and plain floats everywhere else. Loads and stores are unaligned.
+*/
+
+#if defined(__AVX__)
+
+#include <immintrin.h>
+
+typedef __m256 simd_t;
+static const int SIMD_WIDTH = 8;
+
+inline simd_t simdLoad(const float *p) { return _mm256_loadu_ps(p); }
+inline void simdStore(float *p, simd_t v) { _mm256_storeu_ps(p, v); }
+inline simd_t simdSet(float f) { return _mm256_set1_ps(f); }
+inline simd_t simdAdd(simd_t a, simd_t b) { return _mm256_add_ps(a, b); }
+inline simd_t simdSub(simd_t a, simd_t b) { return _mm256_sub_ps(a, b); }
+inline simd_t simdMul(simd_t a, simd_t b) { return _mm256_mul_ps(a, b); }
+inline simd_t simdMax(simd_t a, simd_t b) { return _mm256_max_ps(a, b); }
+
+#elif defined(__SSE__)
+
+#include <xmmintrin.h>
+
+typedef __m128 simd_t;
+static const int SIMD_WIDTH = 4;
+
+inline simd_t simdLoad(const float *p) { return _mm_loadu_ps(p); }
+inline void simdStore(float *p, simd_t v) { _mm_storeu_ps(p, v); }
+inline simd_t simdSet(float f) { return _mm_set1_ps(f); }
+inline simd_t simdAdd(simd_t a, simd_t b) { return _mm_add_ps(a, b); }
+inline simd_t simdSub(simd_t a, simd_t b) { return _mm_sub_ps(a, b); }
+inline simd_t simdMul(simd_t a, simd_t b) { return _mm_mul_ps(a, b); }
+inline simd_t simdMax(simd_t a, simd_t b) { return _mm_max_ps(a, b); }
+
+#else
+
+typedef float simd_t;
+static const int SIMD_WIDTH = 1;
+
+inline simd_t simdLoad(const float *p) { return *p; }
+inline void simdStore(float *p, simd_t v) { *p = v; }
+inline simd_t simdSet(float f) { return f; }
+inline simd_t simdAdd(simd_t a, simd_t b) { return a + b; }
+inline simd_t simdSub(simd_t a, simd_t b) { return a - b; }
+inline simd_t simdMul(simd_t a, simd_t b) { return a * b; }
+inline simd_t simdMax(simd_t a, simd_t b) { return a > b ? a : b; }
+
+#endif
+
+/// Round n up to a whole number of SIMD lanes
+inline int simdRound(int n)
+{
+	return (n + SIMD_WIDTH - 1) / SIMD_WIDTH * SIMD_WIDTH;
+}
+
+#endif
+
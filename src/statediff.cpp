@@ -0,0 +1,27 @@
+#include <cstdio>
+#include <cstring>
+
+#include "sim.h"
+
+/*
+	antigrav-statediff compares the state logs of two runs of a race, as
+	written by antigrav-batch --state-log, and reports the first tick and
+	field where they diverge.
+*/
+
+const char *help_msg =
+"Usage: antigrav-statediff LOG1 LOG2\n\
+Compares two state logs. Exits with 0 if they are identical, 1 if they\n\
+differ and 2 if they can't be read.\n";
+
+int main(int argc, char *argv[])
+{
+	if(argc != 3 || strcmp(argv[1], "-h") == 0 || strcmp(argv[1], "--help") == 0)
+	{
+		fputs(help_msg, argc == 3 ? stdout : stderr);
+		return argc == 3 ? 0 : 2;
+	}
+	
+	int ret = StateLog::compare(argv[1], argv[2]);
+	return ret < 0 ? 2 : ret;
+}
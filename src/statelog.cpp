@@ -0,0 +1,207 @@
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "sim.h"
+
+/*
+	File format:
+
+		"AGSL", version (1 byte), number of crafts (4 bytes)
+		for each tick, starting with the state after World::reset():
+			hash (4 bytes), ring hash (4 bytes),
+			CRAFT_FIELDS floats for each craft
+*/
+
+static const char MAGIC[4] = {'A', 'G', 'S', 'L'};
+
+const char *const StateLog::FIELD_NAMES[CRAFT_FIELDS] = {
+	"x", "y", "angle", "dx", "dy", "dangle", "boost fuel"
+};
+
+StateLog::StateLog()
+{
+	out = NULL;
+}
+
+StateLog::~StateLog()
+{
+	close();
+}
+
+/// Collect the state of a world
+/**
+	@return the hash of the state
+*/
+unsigned int StateLog::sample(World &world, std::vector<float> &values, unsigned int &rings)
+{
+	int numCrafts = world.getActivePlayers();
+	values.resize(numCrafts * CRAFT_FIELDS);
+	
+	for(int i = 0; i < numCrafts; i++)
+	{
+		const Craft &craft = world.getActiveCraft(i);
+		float *v = &values[i * CRAFT_FIELDS];
+		v[0] = craft.getX();
+		v[1] = craft.getY();
+		v[2] = craft.getAngle();
+		v[3] = craft.getVX();
+		v[4] = craft.getVY();
+		v[5] = craft.getOmega();
+		v[6] = craft.getBoostFuel();
+	}
+	
+	rings = world.getRings().hash();
+	
+	unsigned int h = FNV_BASIS;
+	if(!values.empty()) h = fnvHash(h, &values[0], values.size() * sizeof(float));
+	return fnvHash(h, &rings, sizeof(rings));
+}
+
+/// Hash the state of a world
+/**
+	The hash covers the same values as the log, bit for bit.
+*/
+unsigned int StateLog::hash(World &world)
+{
+	std::vector<float> values;
+	unsigned int rings;
+	return sample(world, values, rings);
+}
+
+/// Start logging a race
+/**
+	Call this after World::reset(), it logs the starting grid.
+	@return 0 on success, -1 if the file can't be opened
+*/
+int StateLog::open(const char *filename, World &world)
+{
+	close();
+	
+	out = fopen(filename, "wb");
+	if(out == NULL)
+	{
+		fprintf(stderr, "Can't open %s for writing\n", filename);
+		return -1;
+	}
+	
+	unsigned int numCrafts = world.getActivePlayers();
+	fwrite(MAGIC, 1, sizeof(MAGIC), out);
+	fputc(FORMAT_VERSION, out);
+	fwrite(&numCrafts, sizeof(numCrafts), 1, out);
+	
+	record(world);
+	return 0;
+}
+
+/// Log the state after a tick
+/**
+	Call this after every World::update().
+*/
+void StateLog::record(World &world)
+{
+	if(out == NULL) return;
+	
+	unsigned int rings, h = sample(world, values, rings);
+	fwrite(&h, sizeof(h), 1, out);
+	fwrite(&rings, sizeof(rings), 1, out);
+	if(!values.empty()) fwrite(&values[0], sizeof(float), values.size(), out);
+}
+
+/// Finish the log
+/**
+	@return 0 on success, -1 if the file couldn't be written
+*/
+int StateLog::close()
+{
+	if(out == NULL) return 0;
+	
+	int ret = fclose(out) == 0 ? 0 : -1;
+	out = NULL;
+	if(ret != 0) fprintf(stderr, "Can't write state log\n");
+	return ret;
+}
+
+static FILE *openLog(const char *filename, unsigned int &numCrafts)
+{
+	FILE *in = fopen(filename, "rb");
+	if(in == NULL)
+	{
+		fprintf(stderr, "Can't open %s\n", filename);
+		return NULL;
+	}
+	
+	char magic[sizeof(MAGIC)];
+	if(fread(magic, 1, sizeof(magic), in) != sizeof(magic) || memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 ||
+		fgetc(in) != StateLog::FORMAT_VERSION || fread(&numCrafts, sizeof(numCrafts), 1, in) != 1)
+	{
+		fprintf(stderr, "%s is not a valid state log\n", filename);
+		fclose(in);
+		return NULL;
+	}
+	
+	return in;
+}
+
+/// Compare two state logs
+/**
+	Prints the first tick where the logs differ, and the first field that
+	differs in it.
+	@return 0 if the logs are identical, 1 if they differ, -1 if they
+	can't be read
+*/
+int StateLog::compare(const char *filename1, const char *filename2)
+{
+	unsigned int numCrafts1, numCrafts2;
+	FILE *in1 = openLog(filename1, numCrafts1);
+	FILE *in2 = in1 != NULL ? openLog(filename2, numCrafts2) : NULL;
+	if(in2 == NULL)
+	{
+		if(in1 != NULL) fclose(in1);
+		return -1;
+	}
+	
+	int ret = 0;
+	if(numCrafts1 != numCrafts2)
+	{
+		printf("%s has %u crafts, %s has %u\n", filename1, numCrafts1, filename2, numCrafts2);
+		ret = 1;
+	}
+	
+	// hashes, then the craft fields
+	const int size = 2 * sizeof(unsigned int) + numCrafts1 * CRAFT_FIELDS * sizeof(float);
+	std::vector<char> rec1(size), rec2(size);
+	
+	int tick;
+	for(tick = 0; ret == 0; tick++)
+	{
+		bool end1 = fread(&rec1[0], size, 1, in1) != 1;
+		bool end2 = fread(&rec2[0], size, 1, in2) != 1;
+		
+		if(end1 || end2)
+		{
+			if(end1 != end2) printf("%s ends after %d ticks, %s continues\n", end1 ? filename1 : filename2, tick, end1 ? filename2 : filename1);
+			ret = end1 != end2;
+			break;
+		}
+		
+		if(memcmp(&rec1[0], &rec2[0], size) == 0) continue;
+		
+		ret = 1;
+		printf("tick %d: hash %08x != %08x\n", tick, *(unsigned int *)&rec1[0], *(unsigned int *)&rec2[0]);
+		
+		const float *v1 = (const float *)&rec1[2 * sizeof(unsigned int)];
+		const float *v2 = (const float *)&rec2[2 * sizeof(unsigned int)];
+		unsigned int i = 0;
+		while(i < numCrafts1 * CRAFT_FIELDS && memcmp(&v1[i], &v2[i], sizeof(float)) == 0) i++;
+		
+		if(i < numCrafts1 * CRAFT_FIELDS) printf("craft %u %s: %.9g != %.9g\n", i / CRAFT_FIELDS, FIELD_NAMES[i % CRAFT_FIELDS], v1[i], v2[i]);
+		else printf("rings differ\n");
+	}
+	
+	if(ret == 0) printf("identical, %d ticks\n", tick);
+	
+	fclose(in1);
+	fclose(in2);
+	return ret;
+}
@@ -0,0 +1,50 @@
+#ifndef _STATELOG_H_
+#define _STATELOG_H_
+
+#include <cstdio>
+#include <vector>
+
+static const unsigned int FNV_BASIS = 2166136261u;
+
+/// Fold bytes into a 32 bit FNV-1a hash
+inline unsigned int fnvHash(unsigned int h, const void *data, int len)
+{
+	const unsigned char *p = (const unsigned char *)data;
+	for(int i = 0; i < len; i++) h = (h ^ p[i]) * 16777619u;
+	return h;
+}
+
+/// Per-tick fingerprints of a race
+/**
+	A state log holds, for every tick of a race, a hash of the world
+	state and the values it was computed from: the state and derivative
+	of each active craft, its boost fuel, and a hash of the rings. Two
+	runs of the same race should give identical logs, and compare()
+	finds the first tick and field where they don't. The values are
+	stored in host byte order.
+*/
+class StateLog
+{
+public:
+	static const int FORMAT_VERSION = 1;
+	static const int CRAFT_FIELDS = 7;
+	static const char *const FIELD_NAMES[CRAFT_FIELDS];
+
+	StateLog();
+	~StateLog();
+
+	int open(const char *filename, World &world);
+	void record(World &world);
+	int close();
+
+	static unsigned int hash(World &world);
+	static int compare(const char *filename1, const char *filename2);
+
+private:
+	static unsigned int sample(World &world, std::vector<float> &values, unsigned int &rings);
+
+	FILE *out;
+	std::vector<float> values;
+};
+
+#endif
@@ -1,17 +1,14 @@
-#include "SDL.h"
-#include "SDL_opengl.h"
 #include <cmath>
+#include <cstddef>
 
-#include <AL/al.h>
-
-#include "antigrav.h"
+#include "sim.h"
 
 const float Terrain::VERTEX_DIST = 0.5;
 const float Terrain::HEIGHT_SCALE = 5.0;
-int Terrain::seed = 1;
 
 Terrain::Terrain()
 {
+	seed = 1;
 	width = 0;
 	height = 0;
 	data = NULL;
@@ -19,29 +16,30 @@ Terrain::Terrain()
 	roadTex = 0;
 	goalTex = 0;
 	roadTex2 = 0;
+	texture = 0;
 	listBase = 0;
+	pool = NULL;
+	rowMin = NULL;
+	rowMax = NULL;
 }
 
 Terrain::~Terrain()
 {
+	delete[] rowMax;
+	delete[] rowMin;
 	delete[] normals;
 	delete[] data;
 }
 
-int Terrain::init(int w, int h)
+// Run job(n, arg) for n in [0, count), on the pool when there is one
+static void forEach(WorkerPool *pool, int count, WorkerPool::Job job, void *arg)
 {
-	if(roadTex == 0) roadTex = m3dTexture::loadTexture("road.png");
-	if(roadTex == 0) return -1;
-	if(goalTex == 0) goalTex = m3dTexture::loadTexture("goal.png");
-	if(goalTex == 0) return -1;
-	if(roadTex2 == 0) roadTex2 = m3dTexture::loadTexture("road2.png");
-	if(roadTex2 == 0) return -1;
-	if(texture == 0) texture = m3dTexture::loadTexture("stone.png");
-	if(texture == 0) return -1;
-
-	if(listBase == 0) listBase = glGenLists(64);
-	if(listBase == 0) return -1;
+	if(pool != NULL) pool->run(count, job, arg);
+	else for(int n = 0; n < count; n++) job(n, arg);
+}
 
+int Terrain::init(int w, int h)
+{
 	if(normals) delete[] normals;
 	if(data) delete[] data;
 
@@ -70,6 +68,11 @@ int Terrain::init(int w, int h)
 		delete[] data;
 		return -1;
 	}
+	
+	delete[] rowMin;
+	delete[] rowMax;
+	rowMin = new float[h+1];
+	rowMax = new float[h+1];
 
 	return 0;
 }
@@ -88,12 +91,16 @@ void Terrain::setHeight(int x, int y, float h)
 	data[y * (width + 1) + x] = h;
 }
 
+/// Generate the height field with the diamond-square algorithm
+/**
+	The random numbers are drawn in the same order whether or not the
+	rows of a pass run on a pool: every row starts from the generator
+	state it would have after the rows above it.
+*/
 void Terrain::generate()
 {
 	float scale, ratio;
-	float avg;
 	int s, i, j;
-	int x, y, dim;
 	int xBlocks, yBlocks;
 	int blockSize;
 	int n;
@@ -128,82 +135,126 @@ void Terrain::generate()
 	scale = heightScale * ratio;
 
 
-	dim = 1 << n;
+	passDim = 1 << n;
 	for(s = 0; s < n; s++)
 	{
 		scale *= ratio;
 // 		if(s == n-1) scale = 0.0;	// interpolate last step
 
-		// diamond step
-		for(i = 0; i < (1 << s) * yBlocks; i++)
+		passRows = (1 << s) * yBlocks;
+		passCols = (1 << s) * xBlocks;
+		passScale = scale;
+
+		// diamond step, one random number per square
+		passSeed = seed;
+		forEach(pool, passRows, diamondJob, this);
+		seed = skip(seed, (long)passRows * passCols);
+
+		// square step, one per edge
+		passSeed = seed;
+		forEach(pool, passRows + 1, squareJob, this);
+		seed = skip(seed, (long)passRows * (2 * passCols + 1) + passCols);
+
+		passDim >>= 1;
+	}
+}
+
+// Diamond step of one row of squares
+void Terrain::diamondJob(int i, void *arg)
+{
+	Terrain *t = (Terrain *)arg;
+	const int dim = t->passDim;
+	int seed = skip(t->passSeed, (long)i * t->passCols);
+
+	for(int j = 0; j < t->passCols; j++)
+	{
+		int x = j * dim;
+		int y = i * dim;
+		float avg = 0;
+		avg += t->getHeight(x, y);
+		avg += t->getHeight(x + dim, y);
+		avg += t->getHeight(x + dim, y + dim);
+		avg += t->getHeight(x, y + dim);
+		avg /= 4;
+		t->setHeight(x + (dim >> 1), y + (dim >> 1), avg + t->passScale * (random(seed) - 0.5f));
+	}
+}
+
+// Square step of the edges right of and below one row of corners
+void Terrain::squareJob(int i, void *arg)
+{
+	Terrain *t = (Terrain *)arg;
+	const int dim = t->passDim;
+	int seed = skip(t->passSeed, (long)i * (2 * t->passCols + 1));
+
+	for(int j = 0; j <= t->passCols; j++)
+	{
+		int x = j * dim;
+		int y = i * dim;
+		float avg;
+
+		if(j < t->passCols)
 		{
-			for(j = 0; j < (1 << s) * xBlocks; j++)
-			{
-				x = j * dim;
-				y = i * dim;
-				avg = 0;
-				avg += getHeight(x, y);
-				avg += getHeight(x + dim, y);
-				avg += getHeight(x + dim, y + dim);
-				avg += getHeight(x, y + dim);
-				avg /= 4;
-				setHeight(x + (dim >> 1), y + (dim >> 1), avg + scale * (random() - 0.5f));
-			}
+			avg = 0;
+			avg += t->getHeight(x, y);
+			avg += t->getHeight(x + dim, y);
+			avg /= 2.0;
+			t->setHeight(x + (dim >> 1), y, avg + t->passScale * (random(seed) -0.5f));
 		}
 
-		// square step
-		for(i = 0; i <= (1 << s) * yBlocks; i++)
+		if(i < t->passRows)
 		{
-			for(j = 0; j <= (1 << s) * xBlocks; j++)
-			{
-				x = j * dim;
-				y = i * dim;
-
-				if(j < (1 << s) * xBlocks)
-				{
-					avg = 0;
-					avg += getHeight(x, y);
-					avg += getHeight(x + dim, y);
-					avg /= 2.0;
-					setHeight(x + (dim >> 1), y, avg + scale * (random() -0.5f));
-				}
-
-				if(i < (1 << s) * yBlocks)
-				{
-					avg = 0;
-					avg += getHeight(x, y);
-					avg += getHeight(x, y + dim);
-					avg /= 2.0;
-					setHeight(x, y + (dim >> 1), avg + scale * (random() -0.5f));
-				}
-			}
+			avg = 0;
+			avg += t->getHeight(x, y);
+			avg += t->getHeight(x, y + dim);
+			avg /= 2.0;
+			t->setHeight(x, y + (dim >> 1), avg + t->passScale * (random(seed) -0.5f));
 		}
-
-		dim >>= 1;
 	}
 }
 
 void Terrain::normalize()
 {
 	float min = 1e10, max = -1e10;
-	int i, j;
 
-	for(i = 0; i <= height; i++)
+	forEach(pool, height + 1, rangeJob, this);
+	for(int i = 0; i <= height; i++)
 	{
-		for(j = 0; j <= width; j++)
-		{
-			float h = getHeight(j ,i);
-			if(h < min) min = h;
-			if(h > max) max = h;
-		}
+		if(rowMin[i] < min) min = rowMin[i];
+		if(rowMax[i] > max) max = rowMax[i];
 	}
 
-	for(i = 0; i <= height; i++)
+	rowMin[0] = min;
+	rowMax[0] = max;
+	forEach(pool, height + 1, scaleJob, this);
+}
+
+// Lowest and highest point of a row
+void Terrain::rangeJob(int i, void *arg)
+{
+	Terrain *t = (Terrain *)arg;
+	float min = 1e10, max = -1e10;
+
+	for(int j = 0; j <= t->width; j++)
 	{
-		for(j = 0; j <= width; j++)
-		{
-			setHeight(j, i, (getHeight(j ,i) - min) / (max - min));
-		}
+		float h = t->getHeight(j ,i);
+		if(h < min) min = h;
+		if(h > max) max = h;
+	}
+
+	t->rowMin[i] = min;
+	t->rowMax[i] = max;
+}
+
+// Scale a row to [0, 1], the range of the field is in rowMin[0] and rowMax[0]
+void Terrain::scaleJob(int i, void *arg)
+{
+	Terrain *t = (Terrain *)arg;
+	const float min = t->rowMin[0], max = t->rowMax[0];
+
+	for(int j = 0; j <= t->width; j++)
+	{
+		t->setHeight(j, i, (t->getHeight(j ,i) - min) / (max - min));
 	}
 }
 
@@ -231,6 +282,18 @@ void Terrain::srandom(int s)
 }
 
 float Terrain::random()
+{
+	return random(seed);
+}
+
+/// Spread generation and normal computation over a pool of threads
+/**
+	The results are the same as without a pool.
+*/
+void Terrain::setWorkerPool(WorkerPool *p) { pool = p; }
+
+// Park-Miller minimal standard generator
+float Terrain::random(int &seed)
 {
 	const int a = 48271;
 	const int m  = 2147483647;
@@ -247,29 +310,20 @@ float Terrain::random()
 	return (float)seed / m;
 }
 
-void Terrain::vertex(int x, int y)
-{
-	glNormal3fv(&normals[(y * (width + 1) + x) * 3]);
-	glVertex3f(x * VERTEX_DIST, getHeight(x, y) * HEIGHT_SCALE, y * VERTEX_DIST);
-}
-
-
-void Terrain::draw()
+// The state of the generator n numbers after seed: seed * a^n mod m
+int Terrain::skip(int seed, long n)
 {
-	int i, j;
+	const long long a = 48271;
+	const long long m = 2147483647;
 
-	for(i = 0; i < height - 1; i++)
+	long long result = seed, power = a;
+	for(; n > 0; n >>= 1)
 	{
-		glBegin(GL_TRIANGLE_STRIP);
-
-		for(j = 0; j < width; j++)
-		{
-			vertex(j, i);
-			vertex(j, i+1);
-		}
-
-		glEnd();
+		if(n & 1) result = result * power % m;
+		power = power * power % m;
 	}
+
+	return (int)result;
 }
 
 void Terrain::xproduct(const float *v1, const float *v2, float *result) const
@@ -341,70 +395,84 @@ float Terrain::vectorlen(const float *v) const
 
 void Terrain::computeNormals()
 {
+	forEach(pool, height + 1, normalJob, this);
+}
+
+// Normals of a row of vertices
+void Terrain::normalJob(int i, void *arg)
+{
+	const Terrain *t = (const Terrain *)arg;
 	const int delta[4][2] = {{-1, 0}, {0, 1}, {1, 0}, {0, -1}};
+	const int width = t->width, height = t->height;
 
 	float *normal;
 	float temp[3];
 	float v0[3], v1[3], v2[3];
 	float weight;
-	int i, j, k;
+	int j, k;
 	int x1, y1, x2, y2;
 
-	for(i = 0; i <= height; i++)
+	for(j = 0; j <= width; j++)
 	{
-		for(j = 0; j <= width; j++)
-		{
-			normal = &normals[(i * (width + 1) + j) * 3];
-			normal[0] = 0.0;
-			normal[1] = 0.0;
-			normal[2] = 0.0;
-
+		normal = &t->normals[(i * (width + 1) + j) * 3];
+		normal[0] = 0.0;
+		normal[1] = 0.0;
+		normal[2] = 0.0;
 
-			v0[0] = j * VERTEX_DIST;
-			v0[1] = getHeight(j, i) * HEIGHT_SCALE;
-			v0[2] = i * VERTEX_DIST;
 
-			weight = 0.0;
-			for(k = 0; k < 4; k++)
-			{
-				x1 = j + delta[k][0];
-				y1 = i + delta[k][1];
-				x2 = j + delta[(k+1)%4][0];
-				y2 = i + delta[(k+1)%4][1];
+		v0[0] = j * VERTEX_DIST;
+		v0[1] = t->getHeight(j, i) * HEIGHT_SCALE;
+		v0[2] = i * VERTEX_DIST;
 
-				if(x1 < 0 || x1 > width || y1 < 0 || y1 > height) continue;
-				if(x2 < 0 || x2 > width || y2 < 0 || y2 > height) continue;
+		weight = 0.0;
+		for(k = 0; k < 4; k++)
+		{
+			x1 = j + delta[k][0];
+			y1 = i + delta[k][1];
+			x2 = j + delta[(k+1)%4][0];
+			y2 = i + delta[(k+1)%4][1];
 
-				v1[0] = x1 * VERTEX_DIST;
-				v1[1] = getHeight(x1, y1) * HEIGHT_SCALE;
-				v1[2] = y1 * VERTEX_DIST;
-				vectorsub(v1, v0);
+			if(x1 < 0 || x1 > width || y1 < 0 || y1 > height) continue;
+			if(x2 < 0 || x2 > width || y2 < 0 || y2 > height) continue;
 
-				v2[0] = x2 * VERTEX_DIST;
-				v2[1] = getHeight(x2, y2) * HEIGHT_SCALE;
-				v2[2] = y2 * VERTEX_DIST;
-				vectorsub(v2, v0);
+			v1[0] = x1 * VERTEX_DIST;
+			v1[1] = t->getHeight(x1, y1) * HEIGHT_SCALE;
+			v1[2] = y1 * VERTEX_DIST;
+			t->vectorsub(v1, v0);
 
-				xproduct(v2, v1, temp);
-				vectornorm(temp);
+			v2[0] = x2 * VERTEX_DIST;
+			v2[1] = t->getHeight(x2, y2) * HEIGHT_SCALE;
+			v2[2] = y2 * VERTEX_DIST;
+			t->vectorsub(v2, v0);
 
-				vectoradd(normal, temp);
+			t->xproduct(v2, v1, temp);
+			t->vectornorm(temp);
 
-				weight += 1.0;
-			}
+			t->vectoradd(normal, temp);
 
-			vectormul(1.0 / weight, normal);
+			weight += 1.0;
 		}
+
+		t->vectormul(1.0 / weight, normal);
 	}
 }
 
 void Terrain::descent(int start)
 {
+	passStart = start;
+	forEach(pool, (width + COLUMN_CHUNK) / COLUMN_CHUNK, descentJob, this);
+}
+
+// Descent of a chunk of COLUMN_CHUNK columns
+void Terrain::descentJob(int chunk, void *arg)
+{
+	Terrain *t = (Terrain *)arg;
+	const int start = t->passStart, height = t->height;
 	int i, j;
 
-	for(j = 0; j <= width; j++)
+	for(j = chunk * COLUMN_CHUNK; j < (chunk + 1) * COLUMN_CHUNK && j <= t->width; j++)
 	{
-		float maximum = getHeight(j, start);
+		float maximum = t->getHeight(j, start);
 // 		float minimum = 0.5 * maximum;
 		float minimum = 0.0;
 
@@ -412,116 +480,8 @@ void Terrain::descent(int start)
 		{
 			float x = (float)(i - start - 1) / (height - start - 1);
 			x = 1 - x * x * x;
-			float h = minimum + getHeight(j, i) * x * (maximum - minimum);
-			setHeight(j, i, h);
+			float h = minimum + t->getHeight(j, i) * x * (maximum - minimum);
+			t->setHeight(j, i, h);
 		}
 	}
 }
-
-void Terrain::drawRoad(int n)
-{
-	glBindTexture(GL_TEXTURE_2D, roadTex);
-	for(int i = 0; i < width - 1; i++)
-	{
-		if(i == FINISH_LINE) glBindTexture(GL_TEXTURE_2D, goalTex);
-		if(i == FINISH_LINE+1) glBindTexture(GL_TEXTURE_2D, roadTex2);
-
-		glBegin(GL_TRIANGLE_STRIP);
-		for(int j = 0; j <= 2; j++)
-		{
-			glTexCoord2f(0.0, j * 0.5);
-			vertex(i, j + n - 1);
-			glTexCoord2f(1.0, j * 0.5);
-			vertex(i + 1, j + n - 1);
-		}
-		glEnd();
-	}
-}
-
-void Terrain::createList(GLuint list, int x0, int y0, int w, int h)
-{
-	glNewList(list, GL_COMPILE);
-
-	for(int i = 0; i < w; i++)
-	{
-		glBegin(GL_TRIANGLE_STRIP);
-		for(int j = 0; j <= h; j++)
-		{
-			glTexCoord2f((float)i / w, (float)j / h);
-			vertex(x0 + i, y0 + j);
-			glTexCoord2f((float)(i + 1) / w, (float)j / h);
-			vertex(x0 + i + 1, y0 + j);
-		}
-		glEnd();
-	}
-
-	glEndList();
-}
-
-void Terrain::createLists()
-{
-	for(int i = 0; i < 32; i++)
-	{
-		for(int j =0 ; j < 2; j++)
-		{
-			createList(listBase + j * 32 + i, i * 16, j * 16, 16, 16);
-		}
-	}
-}
-
-void Terrain::drawLists(const float *eye, const float *at, float fovDiag, float dz)
-{
-	float vec[3];
-
-	vec[0] = at[0];
-	vec[1] = at[1];
-	vec[2] = at[2];
-	vectornorm(vec);
-
-	glEnable(GL_TEXTURE_2D);
-	glBindTexture(GL_TEXTURE_2D, texture);
-
-	int drawn = 0;
-
-	for(int i = 0; i < 32; i++)
-	{
-		for(int j = 0; j < 2; j++)
-		{
-			float pos[3] = {i * 16 * VERTEX_DIST - eye[0], 5 - eye[1], j * 16 * VERTEX_DIST + dz - eye[2]};
-			float len;
-			bool inside = false;
-
-			len = vectorlen(pos);
-			if(acosf(dotproduct(pos, vec) / len) < fovDiag) inside = true;
-
-			if(!inside)
-			{
-				pos[0] = (i + 1) * 16 * VERTEX_DIST - eye[0];
-				len = vectorlen(pos);
-				if(acosf(dotproduct(pos, vec) / len) < fovDiag) inside = true;
-			}
-
-			if(!inside)
-			{
-				pos[2] = (j + 1) * 16 * VERTEX_DIST + dz - eye[2];
-				len = vectorlen(pos);
-				if(acosf(dotproduct(pos, vec) / len) < fovDiag) inside = true;
-			}
-
-			if(!inside)
-			{
-				pos[0] = i * 16 * VERTEX_DIST - eye[0];
-				len = vectorlen(pos);
-				if(acosf(dotproduct(pos, vec) / len) < fovDiag) inside = true;
-			}
-
-			if(inside)
-			{
-				glCallList(listBase + j * 32 + i);
-				drawn++;
-			}
-		}
-	}
-
-	glDisable(GL_TEXTURE_2D);
-}
@@ -1,6 +1,8 @@
 #ifndef _TERRAIN_H_
 #define _TERRAIN_H_
 
+class WorkerPool;
+
 class Terrain
 {
 public:
@@ -8,6 +10,7 @@ public:
 	static const float HEIGHT_SCALE;
 	
 	static const int FINISH_LINE = 492;
+	static const int COLUMN_CHUNK = 32;
 	
 	Terrain();
 	~Terrain();
@@ -26,15 +29,28 @@ public:
 	void createLists();
 	
 	int init(int w, int h);
+	int initGraphics();
+	
+	float random();
+	void srandom(int s);
 	
-	static float random();
-	static void srandom(int s);
+	void setWorkerPool(WorkerPool *p);
 	
 	static bool isPow2(int x);
 	static int log2(int x);
 	
 private:
-	static int seed;
+	int seed;
+	
+	static float random(int &seed);
+	static int skip(int seed, long n);
+	
+	static void diamondJob(int row, void *arg);
+	static void squareJob(int row, void *arg);
+	static void rangeJob(int row, void *arg);
+	static void scaleJob(int row, void *arg);
+	static void descentJob(int column, void *arg);
+	static void normalJob(int row, void *arg);
 	
 	void xproduct(const float *v1, const float *v2, float *result) const;
 	float dotproduct(const float *v1 , const float *v2) const;
@@ -49,16 +65,24 @@ private:
 	
 	void vertex(int x, int y);
 	
-	void createList(GLuint list, int x0, int y0, int w, int h);
+	void createList(unsigned int list, int x0, int y0, int w, int h);
 	
 	float *data;
 	float *normals;
 	int width;
 	int height;
 	
-	GLuint roadTex, goalTex, roadTex2;
-	GLuint texture;
-	GLuint listBase;
+	WorkerPool *pool;
+	
+	// parameters of the pass running on the pool
+	int passRows, passCols, passDim, passSeed, passStart;
+	float passScale;
+	float *rowMin, *rowMax;
+	
+	// OpenGL handles, only touched by terrainview.cpp
+	unsigned int roadTex, goalTex, roadTex2;
+	unsigned int texture;
+	unsigned int listBase;
 };
 
 #endif
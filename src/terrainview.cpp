@@ -0,0 +1,161 @@
+#include "SDL_opengl.h"
+#include <cmath>
+
+#include <AL/al.h>
+
+#include "antigrav.h"
+
+/*
+	Drawing of the terrain. Kept apart from terrain.cpp so that the
+	height field can be generated without OpenGL.
+*/
+
+int Terrain::initGraphics()
+{
+	if(roadTex == 0) roadTex = m3dTexture::loadTexture("road.png");
+	if(roadTex == 0) return -1;
+	if(goalTex == 0) goalTex = m3dTexture::loadTexture("goal.png");
+	if(goalTex == 0) return -1;
+	if(roadTex2 == 0) roadTex2 = m3dTexture::loadTexture("road2.png");
+	if(roadTex2 == 0) return -1;
+	if(texture == 0) texture = m3dTexture::loadTexture("stone.png");
+	if(texture == 0) return -1;
+
+	if(listBase == 0) listBase = glGenLists(64);
+	if(listBase == 0) return -1;
+
+	return 0;
+}
+
+void Terrain::vertex(int x, int y)
+{
+	glNormal3fv(&normals[(y * (width + 1) + x) * 3]);
+	glVertex3f(x * VERTEX_DIST, getHeight(x, y) * HEIGHT_SCALE, y * VERTEX_DIST);
+}
+
+
+void Terrain::draw()
+{
+	int i, j;
+
+	for(i = 0; i < height - 1; i++)
+	{
+		glBegin(GL_TRIANGLE_STRIP);
+
+		for(j = 0; j < width; j++)
+		{
+			vertex(j, i);
+			vertex(j, i+1);
+		}
+
+		glEnd();
+	}
+}
+
+void Terrain::drawRoad(int n)
+{
+	glBindTexture(GL_TEXTURE_2D, roadTex);
+	for(int i = 0; i < width - 1; i++)
+	{
+		if(i == FINISH_LINE) glBindTexture(GL_TEXTURE_2D, goalTex);
+		if(i == FINISH_LINE+1) glBindTexture(GL_TEXTURE_2D, roadTex2);
+
+		glBegin(GL_TRIANGLE_STRIP);
+		for(int j = 0; j <= 2; j++)
+		{
+			glTexCoord2f(0.0, j * 0.5);
+			vertex(i, j + n - 1);
+			glTexCoord2f(1.0, j * 0.5);
+			vertex(i + 1, j + n - 1);
+		}
+		glEnd();
+	}
+}
+
+void Terrain::createList(unsigned int list, int x0, int y0, int w, int h)
+{
+	glNewList(list, GL_COMPILE);
+
+	for(int i = 0; i < w; i++)
+	{
+		glBegin(GL_TRIANGLE_STRIP);
+		for(int j = 0; j <= h; j++)
+		{
+			glTexCoord2f((float)i / w, (float)j / h);
+			vertex(x0 + i, y0 + j);
+			glTexCoord2f((float)(i + 1) / w, (float)j / h);
+			vertex(x0 + i + 1, y0 + j);
+		}
+		glEnd();
+	}
+
+	glEndList();
+}
+
+void Terrain::createLists()
+{
+	for(int i = 0; i < 32; i++)
+	{
+		for(int j =0 ; j < 2; j++)
+		{
+			createList(listBase + j * 32 + i, i * 16, j * 16, 16, 16);
+		}
+	}
+}
+
+void Terrain::drawLists(const float *eye, const float *at, float fovDiag, float dz)
+{
+	float vec[3];
+
+	vec[0] = at[0];
+	vec[1] = at[1];
+	vec[2] = at[2];
+	vectornorm(vec);
+
+	glEnable(GL_TEXTURE_2D);
+	glBindTexture(GL_TEXTURE_2D, texture);
+
+	int drawn = 0;
+
+	for(int i = 0; i < 32; i++)
+	{
+		for(int j = 0; j < 2; j++)
+		{
+			float pos[3] = {i * 16 * VERTEX_DIST - eye[0], 5 - eye[1], j * 16 * VERTEX_DIST + dz - eye[2]};
+			float len;
+			bool inside = false;
+
+			len = vectorlen(pos);
+			if(SIM_ACOS(dotproduct(pos, vec) / len) < fovDiag) inside = true;
+
+			if(!inside)
+			{
+				pos[0] = (i + 1) * 16 * VERTEX_DIST - eye[0];
+				len = vectorlen(pos);
+				if(SIM_ACOS(dotproduct(pos, vec) / len) < fovDiag) inside = true;
+			}
+
+			if(!inside)
+			{
+				pos[2] = (j + 1) * 16 * VERTEX_DIST + dz - eye[2];
+				len = vectorlen(pos);
+				if(SIM_ACOS(dotproduct(pos, vec) / len) < fovDiag) inside = true;
+			}
+
+			if(!inside)
+			{
+				pos[0] = i * 16 * VERTEX_DIST - eye[0];
+				len = vectorlen(pos);
+				if(SIM_ACOS(dotproduct(pos, vec) / len) < fovDiag) inside = true;
+			}
+
+			if(inside)
+			{
+				glCallList(listBase + j * 32 + i);
+				drawn++;
+			}
+		}
+	}
+
+	glDisable(GL_TEXTURE_2D);
+}
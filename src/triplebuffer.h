@@ -0,0 +1,52 @@
+#ifndef _TRIPLEBUFFER_H_
+#define _TRIPLEBUFFER_H_
+
+#include <atomic>
+
+/// Hands the latest value from one thread to another without locking
+/**
+	The writer fills the back buffer and publishes it, the reader takes
+	the most recently published one. The third buffer sits between them,
+	so neither side ever waits for the other, and the reader's value
+	stays untouched until it asks for a newer one. Values published
+	while the reader isn't looking are dropped.
+*/
+template <class T> class TripleBuffer
+{
+public:
+	TripleBuffer() : middle(1), back(0), front(2) { }
+
+	/// The buffer to fill, only for the writer
+	T &getBack() { return buffers[back]; }
+
+	/// Hand the back buffer over to the reader
+	void publish()
+	{
+		back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & ~FRESH;
+	}
+
+	/// The latest published value, only for the reader
+	/**
+		@return the value, which is valid until the next call
+	*/
+	T &getFront()
+	{
+		if(middle.load(std::memory_order_relaxed) & FRESH)
+		{
+			front = middle.exchange(front, std::memory_order_acq_rel) & ~FRESH;
+		}
+		return buffers[front];
+	}
+
+private:
+	static const int FRESH = 4;
+
+	T buffers[3];
+
+	// index of the middle buffer, with FRESH set when the reader hasn't
+	// taken it yet
+	std::atomic<int> middle;
+	int back, front;
+};
+
+#endif
@@ -1,6 +1,12 @@
 #ifndef _VECTOR_H_
 #define _VECTOR_H_
 
+#include <math.h>
+
+#if defined(VECTOR2_SSE) && defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
 /// A mathematical 2D Vector
 /**
 	The Vector class is the basis of all mathematics used in the physical
@@ -9,18 +15,23 @@
 	following operators: + (vector addition), - (vector substraction/negation), ^
 	(vector <b>cross</b> product) and * (vector <b>dot</b> product). Operators
 	for scalar multiplication and division are also defined.
+	
+	Everything is defined in this header so that the compiler can inline
+	the arithmetic into the physics loops. configure --enable-vector2-sse
+	defines VECTOR2_SSE, which computes square roots with SSE instructions
+	and gives the same results.
 */
 class Vector2
 {
 public:
-	Vector2();
-	Vector2(float xx, float yy);
+	constexpr Vector2();
+	constexpr Vector2(float xx, float yy);
 	
 	void setX(float xx);
 	void setY(float yy);
-
-	float getX() const;
-	float getY() const;
+	
+	constexpr float getX() const;
+	constexpr float getY() const;
 	float length() const;
 	float angle() const;
 	Vector2 &rotate(float theta);
@@ -28,27 +39,208 @@ public:
 	Vector2 &normalize();
 	
 	Vector2 unitVector() const;
-	Vector2 normalVector() const;
-	
-	Vector2 operator+(const Vector2 &vec) const;
-	Vector2 operator-(const Vector2 &vec) const;
+	constexpr Vector2 normalVector() const;
 	
-	Vector2 &operator=(const Vector2 &other);
+	constexpr Vector2 operator+(const Vector2 &vec) const;
+	constexpr Vector2 operator-(const Vector2 &vec) const;
 	
 	const float *getData() const;
 	
 	/* Vector negation */
-	const Vector2 operator-() const;
-	
+	constexpr Vector2 operator-() const;
+
 private:
+	static float squareRoot(float x);
+	
 	float data[2];
 };
 
+/* Constructors */
+/// Create a zero vector
+/**
+	This is the default constructor for the Vector class. Equivalent to Vector(0, 0)
+	@see Vector(float,float)
+*/
+constexpr Vector2::Vector2() : data{0, 0}
+{
+}
+
+/// Create a new vector
+/**
+	Create a new Vector (xx, yy).
+	@param xx	The x-component of the vector
+	@param yy	The y-component of the vector
+*/
+constexpr Vector2::Vector2(float xx, float yy) : data{xx, yy}
+{
+}
+
+/* Methods */
+/// Set the x-component of this vector
+/**
+	@param xx	the new x-component of this vector.
+*/
+inline void Vector2::setX(float xx)
+{
+	data[0] = xx;
+}
+
+/// Set the y-component of this vector
+/**
+	@param yy	the new x-component of this vector.
+*/
+inline void Vector2::setY(float yy)
+{
+	data[1] = yy;
+}
+
+/// Get the x-component of this vector
+/**
+	@return		The x-component of this vector
+*/
+constexpr float Vector2::getX() const
+{
+	return data[0];
+}
+
+/// Get the y-component of this vector
+/**
+	@return		The y-component of this vector
+*/
+constexpr float Vector2::getY() const
+{
+	return data[1];
+}
+
+inline float Vector2::squareRoot(float x)
+{
+#if defined(VECTOR2_SSE) && defined(__SSE__)
+	return _mm_cvtss_f32(_mm_sqrt_ss(_mm_set_ss(x)));
+#else
+	return sqrt(x);
+#endif
+}
+
+/// Calculate length of this vector
+/**
+	Calculates the length of this vector. The length is defined as
+	sqrt(x<sup>2</sup>+y<sup>2</sup>).
+	@return		The lenght of this vector
+*/
+inline float Vector2::length() const
+{
+	return squareRoot(data[0] * data[0] + data[1] * data[1]);
+}
+
+/// Calculate the angle of this vector
+/**
+	Calculate the angle of this vector. The angle is defined as atan2(y, x);
+	@return 	The angle of this vector in radians.
+*/
+inline float Vector2::angle() const
+{
+	return atan2(data[1], data[0]);
+}
+
+/// Rotate this vector
+/**
+	Rotate this vector theta radians counter clockwise. The rotation operator is defined
+	as x' = Ax, where A is the orthogonal rotation matrix.
+	@param	theta	The angle to rotate in radians. Positive means counterclockwise.
+	@return a reference to this vector
+*/
+inline Vector2& Vector2::rotate(float theta)
+{
+	float c = cos(theta);
+	float s = sin(theta);
+	float tx = c * data[0] - s* data[1];
+	data[1] = s * data[0] + c * data[1];
+	data[0] = tx;
+	
+	return *this;
+}
+
+/// Normalize this vector
+/**
+	This function normalizes this vector, when a vector is normalized, it preserves
+	it direction, but is scaled to have a length of 1.0.
+*/
+inline Vector2& Vector2::normalize()
+{
+	float len = squareRoot(data[0] * data[0] + data[1] * data[1]);
+	data[0] /= len;
+	data[1] /= len;
+	
+	return *this;
+}
+
+constexpr Vector2 Vector2::operator+(const Vector2 &vec) const
+{
+	return Vector2(getX() + vec.getX(), getY() + vec.getY());
+}
+
+constexpr Vector2 Vector2::operator-(const Vector2 &vec) const
+{
+	return Vector2(getX() - vec.getX(), getY() - vec.getY());
+}
+
+/// Get the unit vector of this vector
+/**
+	The unit vector is a vector with the same direction as this one, but a length of 1.0.
+	@return		A new Vector2 which is the unit vector of this vector.
+*/
+inline Vector2 Vector2::unitVector() const
+{
+	Vector2 temp(data[0], data[1]);
+	temp.normalize();
+	return temp;
+}
+
+/// Get the normal vector of this vector
+/**
+	The normal vector is a vector with equal length to this vector, but is normal to
+	this vector (ie. the two vectors form a 90 degree angle).
+	@return		A vector that is normal to this vector and equal in length.
+*/
+constexpr Vector2 Vector2::normalVector() const
+{
+	return Vector2(-data[1], data[0]);
+}
+
+inline const float *Vector2::getData() const { return data; }
+
 /* Operators */
-extern float operator*(const Vector2 &vec1, const Vector2 &vec2);
-extern float operator^(const Vector2 &vec1, const Vector2 &vec2);
-extern Vector2 operator/(const Vector2 &vec, float a);
-extern Vector2 operator*(const Vector2 &vec, float a);
-extern Vector2 operator*(float a, const Vector2 &vec);
+
+constexpr Vector2 Vector2::operator-() const
+{
+	return Vector2(-data[0], -data[1]);
+}
+
+constexpr Vector2 operator*(float a, const Vector2 &vec)
+{
+	return Vector2(vec.getX() * a, vec.getY() * a);
+}
+
+constexpr Vector2 operator*(const Vector2 &vec, float a)
+{
+	return Vector2(vec.getX() * a, vec.getY() * a);
+}
+
+constexpr Vector2 operator/(const Vector2 &vec, float a)
+{
+	return Vector2(vec.getX() / a, vec.getY() / a);
+}
+
+/* Dot product */
+constexpr float operator*(const Vector2 &vec1, const Vector2 &vec2)
+{
+	return vec1.getX() * vec2.getX() + vec1.getY() * vec2.getY();
+}
+
+/* Cross product */
+constexpr float operator^(const Vector2 &vec1, const Vector2 &vec2)
+{
+	return vec1.getX() * vec2.getY() - vec2.getX() * vec1.getY();
+}
 
 #endif
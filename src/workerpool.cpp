@@ -0,0 +1,213 @@
+#include "workerpool.h"
+
+// the pool and queue of a worker thread
+static thread_local const WorkerPool *ownerPool = 0;
+static thread_local int ownerQueue = 0;
+
+WorkerPool::TaskGroup::TaskGroup(WorkerPool *p)
+	: pool(p), pending(0)
+{
+}
+
+WorkerPool::TaskGroup::~TaskGroup()
+{
+	wait();
+}
+
+/// Add jobs to the group
+/**
+	Calls job(n, arg) once for every n in [0, count), in any order and on
+	any thread of the pool. The jobs are split in halves as threads pick
+	them up, so a large count spreads over the pool without a task per
+	job up front.
+*/
+void WorkerPool::TaskGroup::spawn(int count, Job job, void *arg)
+{
+	if(count <= 0) return;
+	
+	if(pool == 0 || pool->threads.empty())
+	{
+		for(int n = 0; n < count; n++) job(n, arg);
+		return;
+	}
+	
+	Task task = {job, arg, 0, count, this};
+	pending++;
+	pool->push(task);
+}
+
+/// Wait for all jobs of the group, running queued tasks meanwhile
+/**
+	When there is nothing left to steal the thread sleeps until a task is
+	queued or the last job of the group finishes.
+*/
+void WorkerPool::TaskGroup::wait()
+{
+	while(pending > 0)
+	{
+		Task task;
+		if(pool->pop(task))
+		{
+			pool->execute(task);
+			continue;
+		}
+		
+		std::unique_lock<std::mutex> lock(pool->mutex);
+		pool->sleeping++;
+		pool->wake.wait(lock, [this] { return pending == 0 || pool->queued > 0; });
+		pool->sleeping--;
+	}
+}
+
+/// Start a pool
+/**
+	@param threads	Total number of threads including the caller, 0 for
+			one per hardware thread.
+*/
+WorkerPool::WorkerPool(int n)
+	: queued(0), sleeping(0), quit(false)
+{
+	if(n <= 0) n = std::thread::hardware_concurrency();
+	if(n <= 0) n = 1;
+	
+	numQueues = n;
+	queues = new Queue[numQueues];
+	
+	for(int i = 0; i < n - 1; i++)
+	{
+		threads.push_back(std::thread(&WorkerPool::worker, this, i));
+	}
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		quit = true;
+	}
+	wake.notify_all();
+	
+	for(unsigned int i = 0; i < threads.size(); i++) threads[i].join();
+	
+	delete[] queues;
+}
+
+int WorkerPool::getNumThreads() const
+{
+	return threads.size() + 1;
+}
+
+/// Run a batch of jobs
+/**
+	Calls job(n, arg) once for every n in [0, count) and returns when all
+	of them have finished. The order in which the jobs run is undefined.
+	This may be called from a job or from several threads at once.
+*/
+void WorkerPool::run(int count, Job job, void *arg)
+{
+	TaskGroup group(this);
+	group.spawn(count, job, arg);
+	group.wait();
+}
+
+// The queue of the calling thread, threads outside the pool share the
+// last one
+int WorkerPool::getQueue() const
+{
+	return ownerPool == this ? ownerQueue : numQueues - 1;
+}
+
+void WorkerPool::push(const Task &task)
+{
+	Queue &q = queues[getQueue()];
+	{
+		std::lock_guard<std::mutex> lock(q.mutex);
+		q.tasks.push_back(task);
+	}
+	
+	// a worker going to sleep either sees the task or is seen here
+	queued++;
+	if(sleeping > 0)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+		}
+		wake.notify_one();
+	}
+}
+
+// Take the newest task of our own queue or steal the oldest of another
+bool WorkerPool::pop(Task &task)
+{
+	const int own = getQueue();
+	
+	for(int i = 0; i < numQueues; i++)
+	{
+		Queue &q = queues[(own + i) % numQueues];
+		std::lock_guard<std::mutex> lock(q.mutex);
+		if(q.tasks.empty()) continue;
+		
+		if(i == 0)
+		{
+			task = q.tasks.back();
+			q.tasks.pop_back();
+		} else
+		{
+			task = q.tasks.front();
+			q.tasks.pop_front();
+		}
+		
+		queued--;
+		return true;
+	}
+	
+	return false;
+}
+
+// Run a task, leaving the upper halves of its range for other threads
+void WorkerPool::execute(Task task)
+{
+	while(task.last - task.first > 1)
+	{
+		Task upper = task;
+		upper.first = (task.first + task.last) / 2;
+		task.last = upper.first;
+		
+		task.group->pending++;
+		push(upper);
+	}
+	
+	task.job(task.first, task.arg);
+	
+	// the group may have a thread sleeping in wait()
+	if(--task.group->pending == 0 && sleeping > 0)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+		}
+		wake.notify_all();
+	}
+}
+
+void WorkerPool::worker(int index)
+{
+	ownerPool = this;
+	ownerQueue = index;
+	
+	while(true)
+	{
+		Task task;
+		if(pop(task))
+		{
+			execute(task);
+			continue;
+		}
+		
+		std::unique_lock<std::mutex> lock(mutex);
+		sleeping++;
+		wake.wait(lock, [this] { return quit || queued > 0; });
+		sleeping--;
+		if(quit) return;
+	}
+}
+
@@ -0,0 +1,93 @@
+#ifndef _WORKERPOOL_H_
+#define _WORKERPOOL_H_
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <vector>
+#include <deque>
+
+/// A fixed set of worker threads
+/**
+	The WorkerPool runs independent jobs on a set of threads that are
+	started once and reused. Every thread has its own queue of tasks: it
+	takes the newest task from its own queue and, when that runs dry,
+	steals the oldest one from another queue. Threads that are not in the
+	pool share one more queue.
+	
+	Jobs are submitted in task groups, and a thread waiting for a group
+	runs queued tasks meanwhile, so jobs can submit and wait for more jobs
+	without tying up the pool. A pool of one thread runs everything in
+	the caller.
+*/
+class WorkerPool
+{
+public:
+	typedef void (*Job)(int n, void *arg);
+	
+	/// Jobs that are waited for together
+	/**
+		A group without a pool runs its jobs right away in spawn().
+		The destructor waits for the jobs that are left.
+	*/
+	class TaskGroup
+	{
+	public:
+		TaskGroup(WorkerPool *pool);
+		~TaskGroup();
+		
+		void spawn(int count, Job job, void *arg);
+		void wait();
+	
+	private:
+		friend class WorkerPool;
+		
+		WorkerPool *pool;
+		std::atomic<int> pending;
+	};
+	
+	WorkerPool(int threads = 0);
+	~WorkerPool();
+	
+	int getNumThreads() const;
+	
+	void run(int count, Job job, void *arg);
+
+private:
+	/// Jobs [first, last) of a group
+	struct Task
+	{
+		Job job;
+		void *arg;
+		int first, last;
+		TaskGroup *group;
+	};
+	
+	struct Queue
+	{
+		std::mutex mutex;
+		std::deque<Task> tasks;
+	};
+	
+	int getQueue() const;
+	void push(const Task &task);
+	bool pop(Task &task);
+	void execute(Task task);
+	void worker(int index);
+	
+	std::vector<std::thread> threads;
+	Queue *queues;
+	int numQueues;
+	
+	// sleeping workers wait for queued to become nonzero, threads in
+	// TaskGroup::wait() also for their group to finish
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::atomic<int> queued;
+	std::atomic<int> sleeping;
+	std::atomic<bool> quit;
+};
+
+#endif
+
@@ -0,0 +1,365 @@
+#include <cmath>
+#include <algorithm>
+
+#include "sim.h"
+
+// Slack added to the broadphase bounds, collisions push crafts 0.03 apart
+const float World::SWEEP_MARGIN = 0.1;
+
+World::World()
+{
+	seed = 0;
+	activePlayers = 0;
+	time = 0.0;
+	integrator = INTEGRATE_BATCH;
+	tolerance = 1e-3;
+	maxSubSteps = 8;
+	subSteps = 0;
+	pool = NULL;
+	stepTime = 0.0;
+	
+	setNumPlayers(DEFAULT_PLAYERS);
+}
+
+/// Set the size of the roster
+/**
+	New players start inactive. Call reset() before the next update.
+*/
+void World::setNumPlayers(int n)
+{
+	int old = players.size();
+	players.resize(n);
+	
+	for(int i = old; i < n; i++)
+	{
+		players[i].setActive(false);
+		players[i].setLocal(false);
+	}
+	
+	// resizing may have moved the players
+	for(int i = 0; i < n; i++) players[i].getCraft().setWorld(this);
+	
+	active.clear();
+	crafts.clear();
+	sweep.clear();
+	activePlayers = 0;
+}
+
+int World::getNumPlayers() const { return players.size(); }
+
+int World::init()
+{
+	if(level.init() != 0) return -1;
+	
+	return 0;
+}
+
+void World::generate(int s)
+{
+	seed = s;
+	level.generate(seed);
+}
+
+// Put the active players on the starting grid and clear the race clock
+/**
+	Also rebuilds the list of active players, so this must be called after
+	players have been activated or deactivated.
+*/
+void World::reset()
+{
+	active.clear();
+	crafts.clear();
+	for(unsigned int i = 0; i < players.size(); i++)
+	{
+		if(!players[i].isActive()) continue;
+		
+		active.push_back(i);
+		crafts.push_back(&players[i].getCraft());
+	}
+	
+	activePlayers = active.size();
+	
+	// large fields start in rows stacked above each other
+	std::vector<float> xPos(activePlayers), yPos(activePlayers), heights(activePlayers);
+	for(int k = 0; k < activePlayers; k++)
+	{
+		int column = k % GRID_COLUMNS;
+		int row = k / GRID_COLUMNS;
+		
+		xPos[k] = 15.0 - column * 0.75;
+		yPos[k] = 0.75 + (column & 1) * 0.5 + row * 1.0;
+	}
+	
+	if(activePlayers > 0) level.getHeights(&xPos[0], &heights[0], activePlayers);
+	
+	sweep.resize(activePlayers);
+	for(int k = 0; k < activePlayers; k++)
+	{
+		players[active[k]].reset(xPos[k], heights[k] + yPos[k]);
+		sweep[k] = k;
+	}
+	
+	sweepMin.resize(activePlayers);
+	sweepMax.resize(activePlayers);
+	sweepTop.resize(activePlayers);
+	sweepBottom.resize(activePlayers);
+	
+	// Clear rings
+	rings.reset();
+	rings.reserve(activePlayers * RingList::RINGS_PER_CRAFT);
+	
+	time = 0.0;
+	subSteps = 0;
+}
+
+/// Advance the race by t seconds
+/**
+	The tick is split into up to getMaxSubSteps() equal steps when a craft
+	could move too far within it, see countSubSteps().
+*/
+void World::update(float t)
+{
+	int n = countSubSteps(t);
+	subSteps += n;
+	
+	for(int i = 0; i < n; i++) step(t / n);
+}
+
+/// Number of steps to split a tick of t seconds into
+/**
+	No craft may move more than half of its clearance from the track in a
+	single step, or less than the craft's thickness when it is closer
+	than that. Crafts far from the track or moving slowly don't force
+	any extra steps.
+*/
+int World::countSubSteps(float t)
+{
+	float worst = 0.0;
+	
+	for(int i = 0; i < activePlayers; i++)
+	{
+		const Craft &craft = *crafts[i];
+		const Vector2 &pos = craft.getPos();
+		
+		float clearance = pos.getY() - level.getHeight(pos.getX()) - Craft::MAJOR_AXIS;
+		float allowed = MAX(0.5 * clearance, Craft::MINOR_AXIS);
+		float steps = craft.getSpeed() * t / allowed;
+		
+		if(steps > worst) worst = steps;
+	}
+	
+	int n = (int)ceil(worst);
+	if(n < 1) n = 1;
+	if(n > maxSubSteps) n = maxSubSteps;
+	
+	return n;
+}
+
+void World::step(float t)
+{
+	time += t;
+	
+	// index the crafts for hover beam queries, they stay put until move()
+	const int n = activePlayers;
+	grid.build(n > 0 ? &crafts[0] : NULL, n, level.getWidth());
+	
+	// integrate crafts, prepare() adds rings so it runs first on this
+	// thread
+	for(int i = 0; i < n; i++) crafts[i]->prepare(t);
+	
+	stepTime = t;
+	if(integrator == INTEGRATE_BATCH)
+	{
+		if(n > 0) batch.integrate(&crafts[0], n, t, pool);
+	} else if(pool != NULL && n > CHUNK)
+	{
+		pool->run((n + CHUNK - 1) / CHUNK, integrateJob, this);
+	} else
+	{
+		for(int chunk = 0; chunk * CHUNK < n; chunk++) integrateJob(chunk, this);
+	}
+	
+	gatherPushes();
+	
+	// update players
+	for(int i = 0; i < n; i++)
+	{
+		Player &player = players[active[i]];
+		if(player.update(t))
+		{
+			// Player finished
+			player.setFinishTime(time);
+		}
+	}
+
+	// Update rings
+	rings.update(t);
+
+	collideCrafts();
+
+	// handle craft to level collisions and move crafts
+	for(int i = 0; i < n; i++)
+	{
+		crafts[i]->levelCollide();
+		crafts[i]->move();
+	}
+}
+
+// Integrate a chunk of crafts with the scalar or adaptive integrator
+void World::integrateJob(int chunk, void *arg)
+{
+	World *world = (World *)arg;
+	int last = MIN((chunk + 1) * CHUNK, world->activePlayers);
+	
+	for(int i = chunk * CHUNK; i < last; i++)
+	{
+		if(world->integrator == INTEGRATE_ADAPTIVE) world->crafts[i]->integrateAdaptive(world->stepTime, world->tolerance);
+		else world->crafts[i]->integrate(world->stepTime);
+	}
+}
+
+/// Collect the pushes of the hover beams for the next step
+/**
+	The crafts are integrated independently, so the forces their beams
+	put on each other are applied a step later. They are summed in craft
+	order, the result doesn't depend on how the integration was split
+	between threads.
+*/
+void World::gatherPushes()
+{
+	const int n = activePlayers;
+	
+	for(int i = 0; i < n; i++) crafts[i]->clearForce();
+	
+	for(int i = 0; i < n; i++)
+	{
+		int target = crafts[i]->getPushTarget();
+		if(target >= 0) crafts[target]->addForce(crafts[i]->getPush());
+	}
+}
+
+/// Handle craft to craft collisions
+/**
+	Sweep and prune along x: the sweep list is kept sorted by the left
+	edge of each craft's bounds with an insertion sort, which is close to
+	linear as the order rarely changes between ticks. Only crafts whose
+	bounds overlap are tested, in the same order as testing every pair.
+*/
+void World::collideCrafts()
+{
+	const int n = activePlayers;
+	
+	for(int i = 0; i < n; i++)
+	{
+		crafts[i]->updateBox();
+		
+		Vector2 pos = crafts[i]->getPos() + crafts[i]->getDPos();
+		const float r = Craft::RADIUS + SWEEP_MARGIN;
+		
+		sweepMin[i] = pos.getX() - r;
+		sweepMax[i] = pos.getX() + r;
+		sweepBottom[i] = pos.getY() - r;
+		sweepTop[i] = pos.getY() + r;
+	}
+	
+	for(int k = 1; k < n; k++)
+	{
+		int i = sweep[k];
+		int l = k - 1;
+		
+		while(l >= 0 && sweepMin[sweep[l]] > sweepMin[i])
+		{
+			sweep[l+1] = sweep[l];
+			l--;
+		}
+		sweep[l+1] = i;
+	}
+	
+	pairs.clear();
+	for(int k = 0; k < n; k++)
+	{
+		int i = sweep[k];
+		
+		for(int l = k + 1; l < n && sweepMin[sweep[l]] <= sweepMax[i]; l++)
+		{
+			int j = sweep[l];
+			if(sweepBottom[i] > sweepTop[j] || sweepBottom[j] > sweepTop[i]) continue;
+			
+			pairs.push_back(i < j ? i * n + j : j * n + i);
+		}
+	}
+	
+	std::sort(pairs.begin(), pairs.end());
+	
+	for(unsigned int p = 0; p < pairs.size(); p++)
+	{
+		Craft &craft1 = *crafts[pairs[p] / n];
+		Craft &craft2 = *crafts[pairs[p] % n];
+		
+		craft1.collide(craft2);
+	}
+}
+
+Level &World::getLevel() { return level; }
+Player &World::getPlayer(int n) { return players[n]; }
+Player &World::getActivePlayer(int n) { return players[active[n]]; }
+Craft &World::getActiveCraft(int n) { return *crafts[n]; }
+RingList &World::getRings() { return rings; }
+const CraftGrid &World::getCraftGrid() const { return grid; }
+
+/// Select how crafts are integrated
+/**
+	INTEGRATE_SCALAR steps each craft on its own with Craft::update,
+	INTEGRATE_BATCH steps all of them together with CraftBatch and
+	INTEGRATE_ADAPTIVE lets each craft choose its own steps within a tick
+	with Craft::updateAdaptive.
+*/
+void World::setIntegrator(int i) { integrator = i; }
+int World::getIntegrator() const { return integrator; }
+
+/// Set the local error allowed per step of the adaptive integrator
+void World::setTolerance(float tol) { tolerance = tol; }
+float World::getTolerance() const { return tolerance; }
+
+/// Spread level generation and the integration of large fields over a pool of threads
+/**
+	Fields of up to CHUNK crafts are always integrated on the calling
+	thread. NULL turns threading off.
+*/
+void World::setWorkerPool(WorkerPool *p)
+{
+	pool = p;
+	level.setWorkerPool(p);
+}
+
+/// Set the largest number of steps a tick may be split into, 1 disables sub-stepping
+void World::setMaxSubSteps(int n) { maxSubSteps = n < 1 ? 1 : n; }
+int World::getMaxSubSteps() const { return maxSubSteps; }
+
+/// Number of steps taken since reset(), at least one per update()
+int World::getSubSteps() const { return subSteps; }
+
+/// Force evaluations made by the active crafts so far
+int World::getDerives() const
+{
+	int n = 0;
+	for(int i = 0; i < activePlayers; i++) n += crafts[i]->getDerives();
+	
+	return n;
+}
+
+int World::getActivePlayers() const { return activePlayers; }
+double World::getTime() const { return time; }
+int World::getSeed() const { return seed; }
+
+int World::getFinishedPlayers() const
+{
+	int n = 0;
+	for(int i = 0; i < activePlayers; i++)
+	{
+		if(players[active[i]].isFinished()) n++;
+	}
+	
+	return n;
+}
+
@@ -0,0 +1,97 @@
+#ifndef _WORLD_H_
+#define _WORLD_H_
+
+#include <vector>
+
+class WorkerPool;
+
+/// A single race
+/**
+	The World owns the track and the players taking part in a race and
+	steps the physical simulation. It knows nothing about rendering or
+	audio, so races can be run without a display.
+*/
+class World
+{
+public:
+	static const int DEFAULT_PLAYERS = 8;
+	
+	static const int INTEGRATE_SCALAR = 0;
+	static const int INTEGRATE_BATCH = 1;
+	static const int INTEGRATE_ADAPTIVE = 2;
+
+	World();
+	
+	int init();
+	
+	void setNumPlayers(int n);
+	int getNumPlayers() const;
+	
+	void generate(int seed);
+	int getSeed() const;
+	void reset();
+	void update(float t);
+	
+	void setIntegrator(int i);
+	int getIntegrator() const;
+	void setTolerance(float tol);
+	float getTolerance() const;
+	
+	void setWorkerPool(WorkerPool *p);
+	
+	void setMaxSubSteps(int n);
+	int getMaxSubSteps() const;
+	int getSubSteps() const;
+	int getDerives() const;
+	
+	Level &getLevel();
+	Player &getPlayer(int n);
+	Player &getActivePlayer(int n);
+	Craft &getActiveCraft(int n);
+	RingList &getRings();
+	const CraftGrid &getCraftGrid() const;
+	
+	int getActivePlayers() const;
+	int getFinishedPlayers() const;
+	double getTime() const;
+	
+private:
+	void step(float t);
+	int countSubSteps(float t);
+	void gatherPushes();
+	void collideCrafts();
+	static void integrateJob(int chunk, void *arg);
+	
+	static const float SWEEP_MARGIN;
+	static const int GRID_COLUMNS = 16;
+	static const int CHUNK = 16;
+	
+	std::vector<Player> players;
+	Level level;
+	RingList rings;
+	
+	int seed;
+	int activePlayers;
+	double time;
+	
+	int integrator;
+	float tolerance;
+	int maxSubSteps, subSteps;
+	CraftBatch batch;
+	CraftGrid grid;
+	
+	WorkerPool *pool;
+	float stepTime;
+	
+	/// Dense list of the players taking part, built by reset()
+	std::vector<int> active;
+	std::vector<Craft *> crafts;
+	
+	/// Active crafts sorted by the left edge of their bounds
+	std::vector<int> sweep;
+	std::vector<float> sweepMin, sweepMax, sweepTop, sweepBottom;
+	std::vector<int> pairs;
+};
+
+#endif
+